@@ -0,0 +1,139 @@
+#include "BatchVerifier.h"
+#include "Game.h"
+#include "FileParser.h"
+#include "GameRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+std::vector<std::string> BatchVerifier::findRecordings(const std::string& rootDir) {
+    std::vector<std::string> dirs;
+    std::error_code ec;
+    if (!fs::is_directory(rootDir, ec)) {
+        FileParser::reportError("Batch directory not found: " + rootDir);
+        return dirs;
+    }
+
+    if (fs::exists(fs::path(rootDir) / GameRecorder::STEPS_FILE, ec)) {
+        dirs.push_back(fs::path(rootDir).string());
+    }
+    for (auto it = fs::recursive_directory_iterator(rootDir, fs::directory_options::skip_permission_denied, ec);
+         it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        if (it->is_directory(ec) && fs::exists(it->path() / GameRecorder::STEPS_FILE, ec)) {
+            dirs.push_back(it->path().string());
+        }
+    }
+
+    std::sort(dirs.begin(), dirs.end());
+    return dirs;
+}
+
+BatchVerifier::RecordingResult BatchVerifier::verifyRecording(const std::string& directory) {
+    RecordingResult result;
+    result.directory = directory;
+    result.error = captureErrors([&]() {
+        Game game(GameMode::LoadSilent, directory);
+        std::string report;
+        result.passed = game.runVerification(report, result.firstMismatchCycle);
+    });
+    return result;
+}
+
+int BatchVerifier::runParallel(size_t count, int threadCount, const std::function<void(size_t)>& work) {
+    if (threadCount <= 0) {
+        threadCount = (int)std::thread::hardware_concurrency();
+        if (threadCount <= 0) threadCount = 1;
+    }
+    threadCount = (int)(std::min)((size_t)threadCount, (std::max)(count, (size_t)1));
+
+    // Each worker pulls the next index until all are taken
+    std::atomic<size_t> nextIndex{0};
+    auto worker = [&]() {
+        for (size_t i = nextIndex++; i < count; i = nextIndex++) {
+            work(i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back(worker);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return threadCount;
+}
+
+std::string BatchVerifier::captureErrors(const std::function<void()>& replay) {
+    // The error handler is per thread, so each worker collects only its own replay's errors
+    std::string error;
+    FileParser::clearErrors();
+    FileParser::setErrorHandler([&error](const std::string& message) {
+        if (error.empty()) error = message;
+    });
+
+    try {
+        replay();
+    } catch (const std::exception& e) {
+        error = std::string("Exception: ") + e.what();
+    }
+
+    FileParser::setErrorHandler(nullptr);
+    return error;
+}
+
+bool BatchVerifier::run(const std::string& rootDir, int threadCount) {
+    std::vector<std::string> recordings = findRecordings(rootDir);
+    if (recordings.empty()) {
+        std::cout << "No recordings (" << GameRecorder::STEPS_FILE << ") found under " << rootDir << std::endl;
+        return false;
+    }
+
+    std::vector<RecordingResult> results(recordings.size());
+
+    auto start = std::chrono::steady_clock::now();
+    threadCount = runParallel(recordings.size(), threadCount, [&](size_t i) {
+        results[i] = verifyRecording(recordings[i]);
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t failed = 0;
+    for (const auto& r : results) {
+        if (!r.passed) ++failed;
+    }
+
+    std::ostringstream oss;
+    oss << "\n========== BATCH VERIFICATION ==========\n";
+    oss << "Recordings: " << results.size() << "  Passed: " << (results.size() - failed)
+        << "  Failed: " << failed << "\n";
+    oss << "Threads:    " << threadCount << "  Time: " << std::fixed << std::setprecision(3) << seconds << " s"
+        << "  Rate: " << std::setprecision(1) << (seconds > 0 ? results.size() / seconds : 0.0)
+        << " recordings/sec\n";
+    oss << "------------------------------------------\n";
+    for (const auto& r : results) {
+        if (r.passed) continue;
+        oss << "[FAIL]  " << r.directory;
+        if (r.firstMismatchCycle >= 0) {
+            oss << " - first mismatch at cycle " << r.firstMismatchCycle;
+        }
+        if (!r.error.empty()) {
+            oss << " - " << r.error;
+        }
+        oss << "\n";
+    }
+    oss << (failed == 0 ? "SUMMARY: All recordings verified successfully!\n" : "SUMMARY: Some recordings failed\n");
+    oss << "==========================================\n";
+    std::cout << oss.str() << std::flush;
+
+    return failed == 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+// Verifies a whole directory tree of recordings (adv-world.steps + adv-world.result pairs).
+// Every recording is replayed silently by its own Game on a pool of worker threads,
+// then one aggregated report is printed.
+class BatchVerifier {
+public:
+    // Outcome of replaying a single recording
+    struct RecordingResult {
+        std::string directory;
+        bool passed = false;
+        int firstMismatchCycle = -1;  // -1 when the recording could not be replayed or fully matched
+        std::string error;            // First error reported while loading/replaying
+    };
+
+    // Find every directory under rootDir that holds a steps file (sorted)
+    static std::vector<std::string> findRecordings(const std::string& rootDir);
+
+    // Replay a single recording and compare it against its expected results
+    static RecordingResult verifyRecording(const std::string& directory);
+
+    // Verify all recordings under rootDir using threadCount workers (0 = hardware concurrency).
+    // Returns true if every recording passed.
+    static bool run(const std::string& rootDir, int threadCount = 0);
+
+    // The worker pool of the verifiers: calls work(i) for every i < count, each index taken by the
+    // next free one of threadCount threads (0 = hardware concurrency). Returns the threads used.
+    static int runParallel(size_t count, int threadCount, const std::function<void(size_t)>& work);
+
+    // Runs one replay on the calling thread with its errors collected instead of printed.
+    // Returns the first error reported, or the exception that ended it ("" if neither).
+    static std::string captureErrors(const std::function<void()>& replay);
+};
@@ -0,0 +1,23 @@
+#include "Benchmark.h"
+#include "FileParser.h"
+#include <iostream>
+#include <exception>
+#include <string>
+
+// Microbenchmarks of the simulation hot paths: cpp-project-bench <name>.
+// A separate executable, as Benchmark.cpp replaces the global operator new to count allocations
+// and the game must keep the standard one.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <glyphs|darkness>" << std::endl;
+        return 1;
+    }
+    try {
+        FileParser::clearErrors();
+        return Benchmark::run(argv[1]) ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,299 @@
+#include "Benchmark.h"
+#include "Glyph.h"
+#include "Screen.h"
+#include "FileParser.h"
+#include "DarkRoom.h"
+#include "Player.h"
+#include "ScreenBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+// Heap allocations made while countingAllocations is set (see the operator new below)
+static std::atomic<bool> countingAllocations{false};
+static std::atomic<size_t> allocationCount{0};
+
+// The global allocation functions, replaced so a benchmark can count the allocations of a hot path.
+// Only the benchmark executable links this file; outside of a counted section they cost one relaxed load.
+void* operator new(std::size_t size) {
+    if (countingAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Glyph classification as it was before the flags table: one comparison chain per predicate
+struct ChainGlyph {
+    static bool isDoor(wchar_t ch) { return ch >= L'A' && ch <= L'Z'; }
+    static bool isKey(wchar_t ch) { return ch >= L'a' && ch <= L'z'; }
+    static bool isRiddle(wchar_t ch) { return ch == Glyph::Riddle || ch == L'\xFF1F'; }
+    static bool isBomb(wchar_t ch) { return ch == Glyph::Bomb; }
+    static bool isTorch(wchar_t ch) { return ch == Glyph::Torch; }
+    static bool isBombableWall(wchar_t ch) { return ch == Glyph::Bombable_Wall_Caret; }
+    static bool isSpring(wchar_t ch) { return ch == Glyph::Spring; }
+    static bool isObstacle(wchar_t ch) { return ch == Glyph::Obstacle; }
+    static bool isSwitch(wchar_t ch) { return ch == Glyph::Switch_Off || ch == Glyph::Switch_On; }
+    static bool isPressureButton(wchar_t ch) { return ch == Glyph::PressureSwitch; }
+    static bool isSpecialDoor(wchar_t ch) { return ch == Glyph::SpecialDoor; }
+    static bool isDarkness(wchar_t ch) {
+        return ch == Glyph::Dark_Light || ch == Glyph::Dark_Medium || ch == Glyph::Dark_Heavy || ch == Glyph::Dark_Full;
+    }
+    static bool isWall(wchar_t ch) {
+        return ch == Glyph::Wall_Single_TL || ch == Glyph::Wall_Single_TR || ch == Glyph::Wall_Single_BL ||
+               ch == Glyph::Wall_Single_BR || ch == Glyph::Wall_Single_H || ch == Glyph::Wall_Single_V ||
+               ch == Glyph::Wall_Single_TRgt || ch == Glyph::Wall_Single_TLft || ch == Glyph::Wall_Single_TDown ||
+               ch == Glyph::Wall_Single_TUp || ch == Glyph::Wall_Single_Cross ||
+               ch == Glyph::Bombable_Wall_H || ch == Glyph::Bombable_Wall_V;
+    }
+};
+
+// Count the cells a predicate holds for, over and over for about a tenth of a second.
+// Returns ns per cell; count is the number of cells it held for in one pass.
+template <class Predicate>
+double timePredicate(const std::vector<wchar_t>& cells, Predicate pred, size_t& count) {
+    using Clock = std::chrono::steady_clock;
+    const auto budget = std::chrono::milliseconds(100);
+    size_t passes = 0;
+    size_t total = 0;
+    auto start = Clock::now();
+    do {
+        for (wchar_t ch : cells) {
+            total += pred(ch) ? 1 : 0;
+        }
+        ++passes;
+    } while (Clock::now() - start < budget);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    count = total / passes;
+    return ns / (double)(passes * cells.size());
+}
+
+// One line of the report: the same predicate both ways. Returns false if they disagree.
+template <class ChainPredicate, class TablePredicate>
+bool comparePredicate(std::ostream& out, const char* name, const std::vector<wchar_t>& cells,
+                      ChainPredicate chain, TablePredicate table) {
+    size_t chainCount = 0, tableCount = 0;
+    double chainNs = timePredicate(cells, chain, chainCount);
+    double tableNs = timePredicate(cells, table, tableCount);
+
+    out << std::left << std::setw(18) << name << std::right << std::fixed << std::setprecision(3)
+        << std::setw(8) << chainNs << " ns" << std::setw(10) << tableNs << " ns"
+        << std::setprecision(2) << std::setw(8) << (tableNs > 0 ? chainNs / tableNs : 0.0) << "x";
+    if (chainCount != tableCount) out << "  DIFFERENT";
+    out << "\n";
+    return chainCount == tableCount;
+}
+
+// Every predicate of one cell packed into a mask, in the order of Glyph::Tile
+template <class G>
+unsigned classify(wchar_t ch) {
+    return (G::isWall(ch) << 0) | (G::isBombableWall(ch) << 1) | (G::isDoor(ch) << 2) | (G::isKey(ch) << 3) |
+           (G::isRiddle(ch) << 4) | (G::isBomb(ch) << 5) | (G::isTorch(ch) << 6) | (G::isSpring(ch) << 7) |
+           (G::isObstacle(ch) << 8) | (G::isSwitch(ch) << 9) | (G::isPressureButton(ch) << 10) |
+           (G::isSpecialDoor(ch) << 11) | (G::isDarkness(ch) << 12);
+}
+
+// Two players walking to and fro inside a dark zone (the first one holding a torch),
+// each call to step() is one tick of movement
+class DarkWalk {
+public:
+    DarkWalk(const DarkZone& zone, int roomIdx) : zone_(zone) {
+        int midY = (zone.getTopLeft().getY() + zone.getBottomRight().getY()) / 2;
+        players_.push_back(Player(Point(zone.getTopLeft().getX(), midY), "wdxase", Glyph::First_Player, roomIdx));
+        players_.push_back(Player(Point(zone.getBottomRight().getX(), midY + 1), "ilmjko", Glyph::Second_Player, roomIdx));
+        players_[0].setCarried('!');
+        previous_.reserve(players_.size());
+    }
+
+    // Move every player one cell, turning around at the edges of the zone; the positions
+    // before the move are kept for updateDarknessAroundPlayers (as the game does)
+    void step() {
+        previous_.clear();
+        for (size_t i = 0; i < players_.size(); ++i) {
+            Point p = players_[i].getPosition();
+            previous_.push_back(p);
+            int x = p.getX() + dir_[i];
+            if (x < zone_.getTopLeft().getX() || x > zone_.getBottomRight().getX()) {
+                dir_[i] = -dir_[i];
+                x = p.getX() + dir_[i];
+            }
+            players_[i].setPosition(Point(x, p.getY()));
+        }
+    }
+
+    const std::vector<Player>& players() const { return players_; }
+    const std::vector<Point>& previous() const { return previous_; }
+
+private:
+    DarkZone zone_;
+    std::vector<Player> players_;
+    std::vector<Point> previous_;
+    int dir_[2] = { 1, -1 };
+};
+
+// Run one tick of a darkness refresh over and over for about a tenth of a second.
+// Returns us per tick; allocations is the number of heap allocations per tick.
+template <class Tick>
+double timeTicks(DarkWalk& walk, Tick tick, double& allocations) {
+    using Clock = std::chrono::steady_clock;
+    const auto budget = std::chrono::milliseconds(100);
+    size_t ticks = 0;
+    allocationCount = 0;
+    countingAllocations = true;
+    auto start = Clock::now();
+    do {
+        walk.step();
+        tick();
+        ++ticks;
+    } while (Clock::now() - start < budget);
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    countingAllocations = false;
+    allocations = (double)allocationCount / (double)ticks;
+    return us / (double)ticks;
+}
+
+} // namespace
+
+bool Benchmark::run(const std::string& name) {
+    if (name == "glyphs") return runGlyphs();
+    if (name == "darkness") return runDarkness();
+    FileParser::reportError("Unknown benchmark: " + name + " (available: glyphs, darkness)");
+    return false;
+}
+
+bool Benchmark::runGlyphs() {
+    // Both implementations must agree on every cell code
+    size_t codeMismatches = 0;
+    for (unsigned c = 0; c <= 0xFFFF; ++c) {
+        if (classify<ChainGlyph>((wchar_t)c) != classify<Glyph>((wchar_t)c)) ++codeMismatches;
+    }
+
+    // The workload is the cells of the level, in the mix the simulation actually sees
+    std::vector<wchar_t> cells;
+    for (const Screen& screen : Screen::loadScreensFromFiles()) {
+        for (int y = 0; y < Screen::MAX_Y; ++y) {
+            for (int x = 0; x < Screen::MAX_X; ++x) {
+                cells.push_back(screen.getCharAt(Point(x, y)));
+            }
+        }
+    }
+    if (cells.empty()) {
+        FileParser::reportError("Benchmark needs the adv-world*.screen files");
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << "\n========== GLYPH CLASSIFICATION ==========\n";
+    oss << "Cells: " << cells.size() << "  (all screens of the level)\n";
+    oss << "Predicate          chains     table   speedup\n";
+    oss << "------------------------------------------\n";
+
+    bool same = (codeMismatches == 0);
+    same &= comparePredicate(oss, "isWall", cells,
+        [](wchar_t ch) { return ChainGlyph::isWall(ch); },
+        [](wchar_t ch) { return Glyph::isWall(ch); });
+    same &= comparePredicate(oss, "isDarkness", cells,
+        [](wchar_t ch) { return ChainGlyph::isDarkness(ch); },
+        [](wchar_t ch) { return Glyph::is(ch, Glyph::Tile::Darkness); });
+    same &= comparePredicate(oss, "wall or door", cells,
+        [](wchar_t ch) { return ChainGlyph::isWall(ch) || ChainGlyph::isDoor(ch); },
+        [](wchar_t ch) { return Glyph::is(ch, Glyph::Tile::Wall | Glyph::Tile::Door); });
+    same &= comparePredicate(oss, "collectible", cells,
+        [](wchar_t ch) { return ChainGlyph::isKey(ch) || ChainGlyph::isBomb(ch) || ChainGlyph::isTorch(ch); },
+        [](wchar_t ch) { return Glyph::is(ch, Glyph::Tile::Collectible); });
+    same &= comparePredicate(oss, "any of the 13", cells,
+        [](wchar_t ch) { return classify<ChainGlyph>(ch) != 0; },
+        [](wchar_t ch) { return Glyph::flags(ch) != 0; });
+
+    oss << "------------------------------------------\n";
+    oss << "Results: " << (same ? "identical" : "DIFFERENT");
+    if (codeMismatches > 0) oss << " (" << codeMismatches << " cell codes disagree)";
+    oss << "\n==========================================\n";
+    std::cout << oss.str() << std::flush;
+
+    return same;
+}
+
+bool Benchmark::runDarkness() {
+    // The workload is the first dark room of the level, with a torch lying in the middle of its first zone
+    std::vector<Screen> world = Screen::loadScreensFromFiles();
+    int roomIdx = -1;
+    for (size_t i = 0; i < world.size() && roomIdx < 0; ++i) {
+        if (DarkRoomManager::roomHasDarkness(world[i])) roomIdx = (int)i;
+    }
+    if (roomIdx < 0) {
+        FileParser::reportError("Benchmark needs a screen with a dark zone (adv-world*.screen files)");
+        return false;
+    }
+    Screen& screen = world[roomIdx];
+    const DarkZone zone = screen.getData().getDarkZones().front();
+    Point torch((zone.getTopLeft().getX() + zone.getBottomRight().getX()) / 2,
+                (zone.getTopLeft().getY() + zone.getBottomRight().getY()) / 2 + 3);
+    screen.setCharAt(torch, Glyph::Torch);
+
+    DarkWalk walk(zone, roomIdx);
+    ScreenBuffer regionBuffer;
+    ScreenBuffer fullBuffer;
+    DarkRoomManager::drawWithDarkness(regionBuffer, screen, walk.players(), roomIdx);
+    auto regionTick = [&]() {
+        DarkRoomManager::updateDarknessAroundPlayers(regionBuffer, screen, walk.players(), roomIdx,
+                                                     walk.previous(), screen.getTorches());
+    };
+    auto fullTick = [&]() {
+        DarkRoomManager::drawWithDarkness(fullBuffer, screen, walk.players(), roomIdx);
+    };
+
+    // The region update must leave the same picture as a full redraw, tick after tick
+    // (these ticks also warm up the scratch storage the update reuses)
+    size_t mismatchedTicks = 0;
+    const int checkedTicks = 200;
+    for (int t = 0; t < checkedTicks; ++t) {
+        walk.step();
+        regionTick();
+        fullTick();
+        bool same = true;
+        for (int y = 0; y < Screen::MAX_Y && same; ++y) {
+            for (int x = 0; x < Screen::MAX_X && same; ++x) {
+                same = regionBuffer.getChar(x, y) == fullBuffer.getChar(x, y);
+            }
+        }
+        if (!same) ++mismatchedTicks;
+    }
+
+    double regionAllocs = 0, fullAllocs = 0;
+    double regionUs = timeTicks(walk, regionTick, regionAllocs);
+    double fullUs = timeTicks(walk, fullTick, fullAllocs);
+
+    std::ostringstream oss;
+    oss << "\n========== DARKNESS UPDATE ==========\n";
+    oss << "Room: " << roomIdx << "  (2 players walking, one holding a torch, one torch lying)\n";
+    oss << "Refresh           us/tick  allocs/tick\n";
+    oss << "-------------------------------------\n";
+    oss << std::fixed << std::setprecision(2);
+    oss << std::left << std::setw(16) << "around players" << std::right << std::setw(9) << regionUs
+        << std::setw(13) << regionAllocs << "\n";
+    oss << std::left << std::setw(16) << "full redraw" << std::right << std::setw(9) << fullUs
+        << std::setw(13) << fullAllocs << "\n";
+    oss << "-------------------------------------\n";
+    oss << "Speedup: " << (regionUs > 0 ? fullUs / regionUs : 0.0) << "x\n";
+    oss << "Results: " << (mismatchedTicks == 0 ? "identical" : "DIFFERENT");
+    if (mismatchedTicks > 0) oss << " (" << mismatchedTicks << " of " << checkedTicks << " ticks differ)";
+    oss << "\n";
+    oss << "Allocations: " << (regionAllocs == 0 ? "none" : "FOUND") << " on the hot path\n";
+    oss << "=====================================\n";
+    std::cout << oss.str() << std::flush;
+
+    return mismatchedTicks == 0 && regionAllocs == 0;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+
+// Microbenchmarks of the hot paths of the simulation, run with "cpp-project-bench <name>".
+// Each benchmark times the current implementation against the one it replaced
+// (or the full redraw it avoids), checks that both give the same answers and
+// prints the time per operation.
+class Benchmark {
+public:
+    // Run the named benchmark ("glyphs", "darkness"). Returns false if it is unknown or the results differ.
+    static bool run(const std::string& name);
+
+private:
+    // Glyph::isX chains of comparisons vs. the constexpr flags table
+    static bool runGlyphs();
+
+    // Per-tick darkness update around moving players vs. a full redraw; also fails if the update allocates
+    static bool runDarkness();
+};
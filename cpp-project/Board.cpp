@@ -1,16 +1,15 @@
 #include "Board.h"
 #include "ScreenBuffer.h"
 #include "DarkRoom.h"
-#include "Glyph.h"
 #include "utils.h"
 #include <set>
 
 // Factory method
-Board* Board::create(bool silent) {
+std::unique_ptr<Board> Board::create(bool silent, ScreenBuffer& buffer) {
     if (silent) {
-        return new SilentBoard();
+        return std::make_unique<SilentBoard>();
     }
-    return new DisplayBoard();
+    return std::make_unique<DisplayBoard>(buffer);
 }
 
 //                                 (__)
@@ -18,19 +17,40 @@ Board* Board::create(bool silent) {
 //  || DisplayBoard Implementation (__)
 //  ||----------------------------||
 
+DisplayBoard::DisplayBoard(ScreenBuffer& buffer) : buffer_(buffer) {
+    buffer_.startRenderThread();
+}
+
+DisplayBoard::~DisplayBoard() {
+    buffer_.stopRenderThread();  // The last frame reaches the console before the board goes
+}
+
+void DisplayBoard::drawRoom(Screen& screen, const std::vector<Player>& players, int roomIdx) {
+    // Get the correct message lines
+    std::string line1, line2, line3;
+    DarkRoomManager::getDarkRoomMessage(screen, players, roomIdx, line1, line2, line3);
+
+    // Render message box content from metadata (if exists)
+    screen.renderMessageBox(line1, line2, line3);
+
+    // Use darkness-aware drawing if room has dark zones
+    if (DarkRoomManager::roomHasDarkness(screen)) {
+        drawScreenWithDarkness(screen, players, roomIdx);
+    } else {
+        drawScreen(screen);
+    }
+}
 
-void DisplayBoard::drawScreen(Screen& screen) {
-    screen.draw();
+void DisplayBoard::drawScreen(const Screen& screen) {
+    screen.draw(buffer_);
 }
 
-void DisplayBoard::drawScreenWithDarkness(Screen& screen, const std::vector<Player>& players, int roomIdx) {
-    DarkRoomManager::drawWithDarkness(screen, players, roomIdx);
+void DisplayBoard::drawScreenWithDarkness(const Screen& screen, const std::vector<Player>& players, int roomIdx) {
+    DarkRoomManager::drawWithDarkness(buffer_, screen, players, roomIdx);
 }
 
 void DisplayBoard::drawPlayers(const std::vector<Player>& players, int visibleRoomIdx) {
     constexpr wchar_t OVERLAP_ICON = L'O';
-    ScreenBuffer& buffer = ScreenBuffer::getInstance();
-    
     // Collect positions of players in current room
     std::vector<std::pair<Point, size_t>> playerPositions;
     for (size_t i = 0; i < players.size(); ++i) {
@@ -54,9 +74,9 @@ void DisplayBoard::drawPlayers(const std::vector<Player>& players, int visibleRo
             }
             
             if (overlapping) {
-                buffer.setChar(pos.getX(), pos.getY(), OVERLAP_ICON);
+                buffer_.setChar(pos.getX(), pos.getY(), OVERLAP_ICON);
             } else {
-                players[idx].draw();
+                players[idx].draw(buffer_);
             }
             drawnPositions.insert(posKey);
         }
@@ -64,29 +84,32 @@ void DisplayBoard::drawPlayers(const std::vector<Player>& players, int visibleRo
 }
 
 void DisplayBoard::drawLegend(Legend& legend, int roomIdx, int hearts, int points, char p1Inv, char p2Inv) {
-    legend.drawLegend(roomIdx, hearts, points, p1Inv, p2Inv);
+    legend.drawLegend(buffer_, roomIdx, hearts, points, p1Inv, p2Inv);
 }
 
-void DisplayBoard::refreshCell(Screen& screen, const Point& p) {
-    screen.refreshCell(p);
+void DisplayBoard::refreshCell(const Screen& screen, const Point& p) {
+    buffer_.setChar(p.getX(), p.getY(), screen.getCharAt(p));
 }
 
-void DisplayBoard::refreshCellWithDarkness(Screen& screen, const Point& p, const std::vector<Player>& players, int roomIdx) {
-    DarkRoomManager::refreshCellWithDarkness(screen, p, players, roomIdx);
+void DisplayBoard::refreshCellWithDarkness(const Screen& screen, const Point& p, const std::vector<Player>& players, int roomIdx) {
+    DarkRoomManager::refreshCellWithDarkness(buffer_, screen, p, players, roomIdx);
 }
 
-void DisplayBoard::updateDarknessAroundPlayers(Screen& screen, const std::vector<Player>& players,
+void DisplayBoard::updateDarknessAroundPlayers(const Screen& screen, const std::vector<Player>& players,
                                                 int roomIdx, const std::vector<Point>& prevPositions,
-                                                const std::vector<Point>& torchSources) {
-    DarkRoomManager::updateDarknessAroundPlayers(screen, players, roomIdx, prevPositions, torchSources);
+                                                bool torchChanged) {
+    // Collect dropped torch positions so they contribute light/halo
+    static const std::vector<Point> noTorches;
+    const std::vector<Point>& torchSources = torchChanged ? screen.getTorches() : noTorches;
+    DarkRoomManager::updateDarknessAroundPlayers(buffer_, screen, players, roomIdx, prevPositions, torchSources);
 }
 
 void DisplayBoard::flush() {
-    ScreenBuffer::getInstance().flush();
+    buffer_.flush();  // Publishes the frame to the render thread
 }
 
 void DisplayBoard::clearScreen() {
-    cls();
+    cls(buffer_);
 }
 
 //                                (__)
@@ -94,11 +117,15 @@ void DisplayBoard::clearScreen() {
 //  || SilentBoard Implementation (__)
 //  ||---------------------------||
 
-void SilentBoard::drawScreen(Screen& /*screen*/) {
+void SilentBoard::drawRoom(Screen& /*screen*/, const std::vector<Player>& /*players*/, int /*roomIdx*/) {
+    // Silent mode - no display
+}
+
+void SilentBoard::drawScreen(const Screen& /*screen*/) {
     // Silent mode - no display
 }
 
-void SilentBoard::drawScreenWithDarkness(Screen& /*screen*/, const std::vector<Player>& /*players*/, int /*roomIdx*/) {
+void SilentBoard::drawScreenWithDarkness(const Screen& /*screen*/, const std::vector<Player>& /*players*/, int /*roomIdx*/) {
     // Silent mode - no display
 }
 
@@ -110,17 +137,17 @@ void SilentBoard::drawLegend(Legend& /*legend*/, int /*roomIdx*/, int /*hearts*/
     // Silent mode - no display
 }
 
-void SilentBoard::refreshCell(Screen& /*screen*/, const Point& /*p*/) {
+void SilentBoard::refreshCell(const Screen& /*screen*/, const Point& /*p*/) {
     // Silent mode - no display
 }
 
-void SilentBoard::refreshCellWithDarkness(Screen& /*screen*/, const Point& /*p*/, const std::vector<Player>& /*players*/, int /*roomIdx*/) {
+void SilentBoard::refreshCellWithDarkness(const Screen& /*screen*/, const Point& /*p*/, const std::vector<Player>& /*players*/, int /*roomIdx*/) {
     // Silent mode - no display
 }
 
-void SilentBoard::updateDarknessAroundPlayers(Screen& /*screen*/, const std::vector<Player>& /*players*/,
+void SilentBoard::updateDarknessAroundPlayers(const Screen& /*screen*/, const std::vector<Player>& /*players*/,
                                                int /*roomIdx*/, const std::vector<Point>& /*prevPositions*/,
-                                               const std::vector<Point>& /*torchSources*/) {
+                                               bool /*torchChanged*/) {
     // Silent mode - no display
 }
 
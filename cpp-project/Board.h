@@ -1,29 +1,35 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <memory>
 #include "Screen.h"
 #include "Player.h"
 #include "Legend.h"
 
 // Forward declarations
 class Game;
+class ScreenBuffer;
 
 // Abstract base class for game board rendering
-// Implements polymorphism for display vs silent modes
+// Implements polymorphism for display vs silent modes.
+// Each Game owns one Board; all drawing (including Screen::refreshCell) goes through it.
 class Board {
 public:
     virtual ~Board() = default;
     
     // Pure virtual methods - must be implemented by derived classes
-    virtual void drawScreen(Screen& screen) = 0;
-    virtual void drawScreenWithDarkness(Screen& screen, const std::vector<Player>& players, int roomIdx) = 0;
+    // Draw a whole room: message box, darkness-aware content
+    virtual void drawRoom(Screen& screen, const std::vector<Player>& players, int roomIdx) = 0;
+    virtual void drawScreen(const Screen& screen) = 0;
+    virtual void drawScreenWithDarkness(const Screen& screen, const std::vector<Player>& players, int roomIdx) = 0;
     virtual void drawPlayers(const std::vector<Player>& players, int visibleRoomIdx) = 0;
     virtual void drawLegend(Legend& legend, int roomIdx, int hearts, int points, char p1Inv, char p2Inv) = 0;
-    virtual void refreshCell(Screen& screen, const Point& p) = 0;
-    virtual void refreshCellWithDarkness(Screen& screen, const Point& p, const std::vector<Player>& players, int roomIdx) = 0;
-    virtual void updateDarknessAroundPlayers(Screen& screen, const std::vector<Player>& players, 
+    virtual void refreshCell(const Screen& screen, const Point& p) = 0;
+    virtual void refreshCellWithDarkness(const Screen& screen, const Point& p, const std::vector<Player>& players, int roomIdx) = 0;
+    // torchChanged = a torch was picked up, dropped or carried in/out, so dropped torches add their halo too
+    virtual void updateDarknessAroundPlayers(const Screen& screen, const std::vector<Player>& players, 
                                               int roomIdx, const std::vector<Point>& prevPositions,
-                                              const std::vector<Point>& torchSources) = 0;
+                                              bool torchChanged) = 0;
     virtual void flush() = 0;
     virtual void clearScreen() = 0;
     
@@ -31,28 +37,34 @@ public:
     virtual bool isDisplayEnabled() const = 0;
     
     // Factory method to create appropriate board type
-    static Board* create(bool silent);
+    static std::unique_ptr<Board> create(bool silent, ScreenBuffer& buffer);
 };
 
-// Display board - renders to screen (for normal play and load mode)
+// Display board - renders to screen (for normal play and load mode).
+// While it exists the buffer's frames are written to the console by a render thread,
+// so a slow console never holds up the game loop.
 class DisplayBoard : public Board {
 public:
-    DisplayBoard() = default;
-    ~DisplayBoard() override = default;
+    explicit DisplayBoard(ScreenBuffer& buffer);
+    ~DisplayBoard() override;
     
-    void drawScreen(Screen& screen) override;
-    void drawScreenWithDarkness(Screen& screen, const std::vector<Player>& players, int roomIdx) override;
+    void drawRoom(Screen& screen, const std::vector<Player>& players, int roomIdx) override;
+    void drawScreen(const Screen& screen) override;
+    void drawScreenWithDarkness(const Screen& screen, const std::vector<Player>& players, int roomIdx) override;
     void drawPlayers(const std::vector<Player>& players, int visibleRoomIdx) override;
     void drawLegend(Legend& legend, int roomIdx, int hearts, int points, char p1Inv, char p2Inv) override;
-    void refreshCell(Screen& screen, const Point& p) override;
-    void refreshCellWithDarkness(Screen& screen, const Point& p, const std::vector<Player>& players, int roomIdx) override;
-    void updateDarknessAroundPlayers(Screen& screen, const std::vector<Player>& players,
+    void refreshCell(const Screen& screen, const Point& p) override;
+    void refreshCellWithDarkness(const Screen& screen, const Point& p, const std::vector<Player>& players, int roomIdx) override;
+    void updateDarknessAroundPlayers(const Screen& screen, const std::vector<Player>& players,
                                       int roomIdx, const std::vector<Point>& prevPositions,
-                                      const std::vector<Point>& torchSources) override;
+                                      bool torchChanged) override;
     void flush() override;
     void clearScreen() override;
     
     bool isDisplayEnabled() const override { return true; }
+
+private:
+    ScreenBuffer& buffer_;
 };
 
 // Silent board - no rendering (for silent testing mode)
@@ -61,15 +73,16 @@ public:
     SilentBoard() = default;
     ~SilentBoard() override = default;
     
-    void drawScreen(Screen& screen) override;
-    void drawScreenWithDarkness(Screen& screen, const std::vector<Player>& players, int roomIdx) override;
+    void drawRoom(Screen& screen, const std::vector<Player>& players, int roomIdx) override;
+    void drawScreen(const Screen& screen) override;
+    void drawScreenWithDarkness(const Screen& screen, const std::vector<Player>& players, int roomIdx) override;
     void drawPlayers(const std::vector<Player>& players, int visibleRoomIdx) override;
     void drawLegend(Legend& legend, int roomIdx, int hearts, int points, char p1Inv, char p2Inv) override;
-    void refreshCell(Screen& screen, const Point& p) override;
-    void refreshCellWithDarkness(Screen& screen, const Point& p, const std::vector<Player>& players, int roomIdx) override;
-    void updateDarknessAroundPlayers(Screen& screen, const std::vector<Player>& players,
+    void refreshCell(const Screen& screen, const Point& p) override;
+    void refreshCellWithDarkness(const Screen& screen, const Point& p, const std::vector<Player>& players, int roomIdx) override;
+    void updateDarknessAroundPlayers(const Screen& screen, const std::vector<Player>& players,
                                       int roomIdx, const std::vector<Point>& prevPositions,
-                                      const std::vector<Point>& torchSources) override;
+                                      bool torchChanged) override;
     void flush() override;
     void clearScreen() override;
     
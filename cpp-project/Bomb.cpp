@@ -33,50 +33,37 @@ std::vector<int> Bomb::explode(Game& game) {
     int maxX = (std::min)(Screen::MAX_X - 1, position.getX() + radius);
     int minY = (std::max)(0, position.getY() - radius);
     int maxY = (std::min)(Screen::MAX_Y - 1, position.getY() + radius);
+    const CellMask blast = CellMask::rect(minX, minY, maxX, maxY);
 
     // Destroy weak walls (^) in blast radius
-    for (int y = minY; y <= maxY; ++y) {
-        for (int x = minX; x <= maxX; ++x) {
-            Point p(x, y);
-            wchar_t c = s.getCharAt(p);
-            if (Glyph::isBombableWall(c)) {
-                s.setCharAt(p, Glyph::Empty);
-                if (roomIdx == game.getVisibleRoomIdx()) {
-                    s.refreshCell(p);
-                }
-            }
+    (s.getBombableMask() & blast).forEach([&](int x, int y) {
+        Point p(x, y);
+        s.setCharAt(p, Glyph::Empty);
+        if (roomIdx == game.getVisibleRoomIdx()) {
+            s.refreshCell(p);
         }
-    }
+    });
 
     // Find and destroy obstacles that have at least one cell in the blast radius
-    std::set<Obstacle*> obstaclesToDestroy;
-    for (int y = minY; y <= maxY; ++y) {
-        for (int x = minX; x <= maxX; ++x) {
-            Point p(x, y);
-            wchar_t c = s.getCharAt(p);
-            if (Glyph::isObstacle(c)) {
-                Obstacle* obs = Obstacle::findAt(s, roomIdx, p);
-                if (obs) {
-                    obstaclesToDestroy.insert(obs);
-                }
-            }
+    ObstacleRegistry& obstacles = game.getObstacles();
+    std::set<int> obstaclesToDestroy;
+    (s.getObstacleMask() & blast).forEach([&](int x, int y) {
+        int id = obstacles.idAt(roomIdx, Point(x, y));
+        if (id >= 0) {
+            obstaclesToDestroy.insert(id);
         }
-    }
+    });
 
     // Destroy all affected obstacles (erase all their cells from all rooms)
-    for (Obstacle* obs : obstaclesToDestroy) {
-        for (const auto& cell : obs->getCells()) {
+    for (int id : obstaclesToDestroy) {
+        for (const auto& cell : obstacles.get(id)->getCells()) {
             Screen& cellScreen = game.getScreen(cell.getRoomIdx());
             cellScreen.setCharAt(cell.getPos(), Glyph::Empty);
             if (cell.getRoomIdx() == game.getVisibleRoomIdx()) {
                 cellScreen.refreshCell(cell.getPos());
             }
         }
-    }
-
-    // Rescan obstacles if any were destroyed
-    if (!obstaclesToDestroy.empty()) {
-        game.rescanObstacles();
+        obstacles.remove(id);
     }
 
     // Damage players: each player hit = 1 heart lost
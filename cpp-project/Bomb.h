@@ -21,6 +21,7 @@ public:
 
     Point getPosition() const { return position; }
     int getRoomIdx() const { return roomIdx; }
+    int getTicksLeft() const { return ticksLeft; }
 
     void setPosition(Point p) { position = p; }
     
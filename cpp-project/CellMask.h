@@ -0,0 +1,178 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "Point.h"
+
+// One bit per cell of a screen (80x25 = 2000 bits, row-major: bit y*80+x).
+// Screens keep one mask per kind of cell up to date as cells change, so collision,
+// blast and darkness queries are bit tests and area queries work a word at a time.
+class CellMask {
+public:
+    static constexpr int WIDTH = 80;
+    static constexpr int HEIGHT = 25;
+    static constexpr int CELLS = WIDTH * HEIGHT;
+    static constexpr int WORDS = (CELLS + 63) / 64;
+
+    static constexpr bool inBounds(int x, int y) { return x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT; }
+
+    bool test(int x, int y) const {
+        if (!inBounds(x, y)) return false;
+        int i = y * WIDTH + x;
+        return (words_[i >> 6] >> (i & 63)) & 1;
+    }
+    bool test(const Point& p) const { return test(p.getX(), p.getY()); }
+
+    void set(int x, int y, bool value = true) {
+        if (!inBounds(x, y)) return;
+        int i = y * WIDTH + x;
+        uint64_t bit = 1ULL << (i & 63);
+        words_[i >> 6] = value ? (words_[i >> 6] | bit) : (words_[i >> 6] & ~bit);
+    }
+    void set(const Point& p, bool value = true) { set(p.getX(), p.getY(), value); }
+
+    void clear() { words_.fill(0); }
+
+    bool any() const {
+        for (uint64_t w : words_) {
+            if (w) return true;
+        }
+        return false;
+    }
+
+    int count() const {
+        int n = 0;
+        for (uint64_t w : words_) n += std::popcount(w);
+        return n;
+    }
+
+    // Bit index (y*80+x) of the first set cell in row-major order, -1 if none
+    int first() const {
+        for (int w = 0; w < WORDS; ++w) {
+            if (words_[w]) return w * 64 + std::countr_zero(words_[w]);
+        }
+        return -1;
+    }
+
+    // Call f(x, y) for every set cell, in row-major order
+    template <class F>
+    void forEach(F f) const {
+        for (int w = 0; w < WORDS; ++w) {
+            for (uint64_t bits = words_[w]; bits; bits &= bits - 1) {
+                int i = w * 64 + std::countr_zero(bits);
+                f(i % WIDTH, i / WIDTH);
+            }
+        }
+    }
+
+    // Cells x0..x1, y0..y1 (inclusive, clamped to the screen)
+    static CellMask rect(int x0, int y0, int x1, int y1) {
+        CellMask m;
+        x0 = x0 < 0 ? 0 : x0;
+        y0 = y0 < 0 ? 0 : y0;
+        x1 = x1 >= WIDTH ? WIDTH - 1 : x1;
+        y1 = y1 >= HEIGHT ? HEIGHT - 1 : y1;
+        if (x0 > x1) return m;
+        for (int y = y0; y <= y1; ++y) {
+            m.setRange(y * WIDTH + x0, y * WIDTH + x1 + 1);
+        }
+        return m;
+    }
+
+    // Column x / row y as a mask (screen edges, for crossing into the next room)
+    static CellMask column(int x) { return rect(x, 0, x, HEIGHT - 1); }
+    static CellMask row(int y) { return rect(0, y, WIDTH - 1, y); }
+
+    // The same cells moved by dx, dy; cells that leave the screen are dropped
+    CellMask shifted(int dx, int dy) const {
+        CellMask m = *this;
+        if (dx > 0) m = m.shiftedBits(dx) & ~leftColumns(dx);
+        else if (dx < 0) m = m.shiftedBits(dx) & ~rightColumns(-dx);
+        if (dy != 0) m = m.shiftedBits(dy * WIDTH);
+        return m;
+    }
+
+    // The cells plus their 4-neighbours
+    CellMask grown() const {
+        static const CellMask notFirstColumn = ~column(0);
+        static const CellMask notLastColumn = ~column(WIDTH - 1);
+        return *this | (shiftedBits(1) & notFirstColumn) | (shiftedBits(-1) & notLastColumn) |
+               shiftedBits(WIDTH) | shiftedBits(-WIDTH);
+    }
+
+    // All cells of allowed 4-connected to seed (within this screen)
+    static CellMask flood(const CellMask& seed, const CellMask& allowed) {
+        CellMask filled = seed & allowed;
+        for (;;) {
+            CellMask next = filled.grown() & allowed;
+            if (next == filled) return filled;
+            filled = next;
+        }
+    }
+
+    bool intersects(const CellMask& o) const {
+        for (int w = 0; w < WORDS; ++w) {
+            if (words_[w] & o.words_[w]) return true;
+        }
+        return false;
+    }
+
+    CellMask& operator&=(const CellMask& o) { for (int w = 0; w < WORDS; ++w) words_[w] &= o.words_[w]; return *this; }
+    CellMask& operator|=(const CellMask& o) { for (int w = 0; w < WORDS; ++w) words_[w] |= o.words_[w]; return *this; }
+    CellMask& operator^=(const CellMask& o) { for (int w = 0; w < WORDS; ++w) words_[w] ^= o.words_[w]; return *this; }
+    CellMask operator&(const CellMask& o) const { CellMask m = *this; return m &= o; }
+    CellMask operator|(const CellMask& o) const { CellMask m = *this; return m |= o; }
+    CellMask operator^(const CellMask& o) const { CellMask m = *this; return m ^= o; }
+    CellMask operator~() const {
+        CellMask m;
+        for (int w = 0; w < WORDS; ++w) m.words_[w] = ~words_[w];
+        m.words_[WORDS - 1] &= LAST_WORD_BITS;
+        return m;
+    }
+    bool operator==(const CellMask& o) const { return words_ == o.words_; }
+    bool operator!=(const CellMask& o) const { return words_ != o.words_; }
+
+private:
+    static constexpr uint64_t LAST_WORD_BITS = (CELLS % 64) ? ((1ULL << (CELLS % 64)) - 1) : ~0ULL;
+
+    std::array<uint64_t, WORDS> words_{};
+
+    // Set bits [begin, end)
+    void setRange(int begin, int end) {
+        while (begin < end) {
+            int w = begin >> 6;
+            int lo = begin & 63;
+            int hi = (end - (w << 6)) < 64 ? (end - (w << 6)) : 64;
+            uint64_t bits = (hi == 64 ? ~0ULL : ((1ULL << hi) - 1)) & (~0ULL << lo);
+            words_[w] |= bits;
+            begin = (w << 6) + hi;
+        }
+    }
+
+    // Every bit moved by n positions (towards higher indices for n > 0); bits past the end are dropped
+    CellMask shiftedBits(int n) const {
+        CellMask m;
+        if (n >= CELLS || -n >= CELLS) return m;
+        if (n >= 0) {
+            int wordShift = n >> 6, bitShift = n & 63;
+            for (int w = WORDS - 1; w >= wordShift; --w) {
+                uint64_t v = words_[w - wordShift] << bitShift;
+                if (bitShift && w - wordShift - 1 >= 0) v |= words_[w - wordShift - 1] >> (64 - bitShift);
+                m.words_[w] = v;
+            }
+        } else {
+            n = -n;
+            int wordShift = n >> 6, bitShift = n & 63;
+            for (int w = 0; w + wordShift < WORDS; ++w) {
+                uint64_t v = words_[w + wordShift] >> bitShift;
+                if (bitShift && w + wordShift + 1 < WORDS) v |= words_[w + wordShift + 1] << (64 - bitShift);
+                m.words_[w] = v;
+            }
+        }
+        m.words_[WORDS - 1] &= LAST_WORD_BITS;
+        return m;
+    }
+
+    static CellMask leftColumns(int n) { return rect(0, 0, n - 1, HEIGHT - 1); }
+    static CellMask rightColumns(int n) { return rect(WIDTH - n, 0, WIDTH - 1, HEIGHT - 1); }
+};
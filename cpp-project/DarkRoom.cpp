@@ -4,32 +4,15 @@
 #include "Player.h"
 #include "Glyph.h"
 #include "ScreenMetadata.h"
-#define NOMINMAX
-#include <windows.h>
 #include <cmath>
 #include <algorithm>
 #include <set>
-#include <map>
 
 // This file written by AI :)
 
-// Ensure Windows min/max macros do not clash with std::min/std::max if windows.h was pulled in earlier
-#ifdef max
-#undef max
-#endif
-#ifdef min
-#undef min
-#endif
-
 // Check if a point is in any dark zone of the given screen
 bool DarkRoomManager::isInDarkZone(const Screen& screen, const Point& p) {
-    const auto& darkZones = screen.getData().getDarkZones();
-    for (const auto& zone : darkZones) {
-        if (zone.contains(p)) {
-            return true;
-        }
-    }
-    return false;
+    return screen.getDarkMask().test(p);
 }
 
 // Check if the room has any dark zones
@@ -48,17 +31,7 @@ bool DarkRoomManager::isTorchAvailable(const Screen& screen, const std::vector<P
     
     
     // Check if there's a torch anywhere in this screen
-    for (int y = 0; y < Screen::MAX_Y; ++y) {
-        for (int x = 0; x < Screen::MAX_X; ++x) {
-            Point p{x, y};
-            if (Glyph::isTorch(screen.getCharAt(p))) {
-                return true;
-            }
-        }
-    }
-    
-    
-    return false;
+    return !screen.getTorches().empty();
 }
 
 // Update the info message area for dark rooms
@@ -135,59 +108,23 @@ int DarkRoomManager::closestTorchDistance(const Point& pos, const std::vector<Pl
     return minDist;
 }
 
-// Find closest dropped torch distance to a point
-int DarkRoomManager::closestDroppedTorchDistance(const Point& pos, const Screen& screen) {
-int minDist = 9999;
-
-// Fixed 8x8 window (radius 4) around the queried cell to keep the scan tiny.
-const int searchRadius = 4;
-int minY = std::max(0, pos.getY() - searchRadius);
-int maxY = std::min(Screen::MAX_Y - 1, pos.getY() + searchRadius);
-int minX = std::max(0, pos.getX() - searchRadius);
-int maxX = std::min(Screen::MAX_X - 1, pos.getX() + searchRadius);
-
-for (int y = minY; y <= maxY; ++y) {
-    for (int x = minX; x <= maxX; ++x) {
-        Point torchPos(x, y);
-        if (Glyph::isTorch(screen.getCharAt(torchPos))) {
-            int dist = calculateDistance(pos, torchPos);
-                if (dist < minDist) {
-                    minDist = dist;
-                    if (minDist == 0) return 0; // can't do better
-                }
-            }
-        }
-    }
-    return minDist;
+// Darkness level at a position considering all light sources
+int DarkRoomManager::lightLevel(const Point& pos, const std::vector<Player>& players, int roomIdx, const Screen& screen) {
+    return screen.syncLightmap(players, roomIdx).levelAt(pos);
 }
 
-// Find minimum distance to any light source (held or dropped torch)
-int DarkRoomManager::closestLightSourceDistance(const Point& pos, const std::vector<Player>& players, 
-                                                 int roomIdx, const Screen& screen) {
-    int heldDist = closestTorchDistance(pos, players, roomIdx);
-    int droppedDist = closestDroppedTorchDistance(pos, screen);
-    return (heldDist < droppedDist) ? heldDist : droppedDist;
+// Get the darkness level at a position (held torches only)
+int DarkRoomManager::getDarknessLevel(const Point& pos, const std::vector<Player>& players, int roomIdx) {
+    return levelFromDistance(closestTorchDistance(pos, players, roomIdx));
 }
 
-// Get the darkness level at a position (considers both held and dropped torches)
-int DarkRoomManager::getDarknessLevel(const Point& pos, const std::vector<Player>& players, int roomIdx) {
-    // This version only considers held torches - use getDarknessLevelWithDropped for full check
-    int dist = closestTorchDistance(pos, players, roomIdx);
-    
+// Darkness level at a distance from the closest light
+int DarkRoomManager::levelFromDistance(int dist) {
     if (dist <= FULL_LIGHT_RADIUS) return 0;      // Full visibility
     if (dist == LIGHT_SHADE_RADIUS) return 1;     // ░
     if (dist == MEDIUM_SHADE_RADIUS) return 2;    // ▒
     if (dist == HEAVY_SHADE_RADIUS) return 3;     // ▓
-    return 4;                                     // █
-}
-
-// Get darkness level considering all light sources
-static int getDarknessLevelFromDistance(int dist) {
-    if (dist <= DarkRoomManager::FULL_LIGHT_RADIUS) return 0;
-    if (dist == DarkRoomManager::LIGHT_SHADE_RADIUS) return 1;
-    if (dist == DarkRoomManager::MEDIUM_SHADE_RADIUS) return 2;
-    if (dist == DarkRoomManager::HEAVY_SHADE_RADIUS) return 3;
-    return 4;
+    return FULL_DARK_LEVEL;                       // █
 }
 
 // Check if player can move to target position
@@ -204,8 +141,7 @@ bool DarkRoomManager::canEnterPosition(const Screen& screen, const Player& playe
     }
     
     // Check if target is lit by any light source (held by other players OR dropped torches)
-    int lightDist = closestLightSourceDistance(target, allPlayers, roomIdx, screen);
-    if (lightDist <= FULL_LIGHT_RADIUS) {
+    if (lightLevel(target, allPlayers, roomIdx, screen) == 0) {
         return true;  // Area is lit by another player's torch or dropped torch
     }
     
@@ -233,9 +169,8 @@ wchar_t DarkRoomManager::getDisplayChar(const Screen& screen, const Point& pos,
         }
     }
     
-    // Calculate distance to closest light source (held or dropped torch)
-    int lightDist = closestLightSourceDistance(pos, players, currentRoomIdx, screen);
-    int darkLevel = getDarknessLevelFromDistance(lightDist);
+    // Darkness from the closest light source (held or dropped torch)
+    int darkLevel = lightLevel(pos, players, currentRoomIdx, screen);
     
     if (darkLevel == 0) {
         return originalChar;  // Full visibility
@@ -246,8 +181,7 @@ wchar_t DarkRoomManager::getDisplayChar(const Screen& screen, const Point& pos,
 }
 
 // Draw the screen with darkness overlay (includes player drawing to prevent flicker)
-void DarkRoomManager::drawWithDarkness(const Screen& screen, const std::vector<Player>& players, int roomIdx) {
-    ScreenBuffer& buffer = ScreenBuffer::getInstance();
+void DarkRoomManager::drawWithDarkness(ScreenBuffer& buffer, const Screen& screen, const std::vector<Player>& players, int roomIdx) {
     
     bool hasDarkZones = roomHasDarkness(screen);
     
@@ -306,7 +240,7 @@ void DarkRoomManager::drawWithDarkness(const Screen& screen, const std::vector<P
 }
 
 // Refresh a single cell with darkness consideration
-void DarkRoomManager::refreshCellWithDarkness(const Screen& screen, const Point& p,
+void DarkRoomManager::refreshCellWithDarkness(ScreenBuffer& buffer, const Screen& screen, const Point& p,
                                                const std::vector<Player>& players, int roomIdx) {
     if (p.getX() < 0 || p.getX() >= Screen::MAX_X || p.getY() < 0 || p.getY() >= Screen::MAX_Y) return;
     
@@ -317,109 +251,78 @@ void DarkRoomManager::refreshCellWithDarkness(const Screen& screen, const Point&
         ch = screen.getCharAt(p);
     }
     
-    ScreenBuffer::getInstance().setChar(p.getX(), p.getY(), ch);
+    buffer.setChar(p.getX(), p.getY(), ch);
 }
 
 
 // Update only the cells affected by player movement - much faster than full redraw
-void DarkRoomManager::updateDarknessAroundPlayers(const Screen& screen, const std::vector<Player>& players,
+void DarkRoomManager::updateDarknessAroundPlayers(ScreenBuffer& buffer, const Screen& screen, const std::vector<Player>& players,
                                                    int roomIdx, const std::vector<Point>& previousPositions,
                                                    const std::vector<Point>& extraLightSources) {
     if (!roomHasDarkness(screen)) return;
-    ScreenBuffer& buffer = ScreenBuffer::getInstance();
     
     // Collect all cells that need updating (within light radius of current and previous positions)
-    std::set<std::pair<int,int>> cellsToUpdate;
-    
     // Light spreads wider horizontally because calculateDistance scales dx by 0.75.
     // Cover that extra reach so we clear lingering halo artifacts.
     const int updateRadius = (HEAVY_SHADE_RADIUS * 4) / 3 + 1; // 9 -> 13
+    auto around = [updateRadius](const Point& c) {
+        return CellMask::rect(c.getX() - updateRadius, c.getY() - updateRadius,
+                              c.getX() + updateRadius, c.getY() + updateRadius);
+    };
     
-    // Add cells around previous positions (to clear old light) – only within dark zones
+    // Cells around previous positions (to clear old light), current player positions
+    // (to draw new light) and extra light sources (e.g., dropped torches) - only within dark zones
+    CellMask litArea;
     for (const auto& prevPos : previousPositions) {
-        for (int dy = -updateRadius; dy <= updateRadius; ++dy) {
-            for (int dx = -updateRadius; dx <= updateRadius; ++dx) {
-                int nx = prevPos.getX() + dx;
-                int ny = prevPos.getY() + dy;
-                if (nx >= 0 && nx < Screen::MAX_X && ny >= 0 && ny < Screen::MAX_Y) {
-                    Point q(nx, ny);
-                    if (isInDarkZone(screen, q)) {
-                        cellsToUpdate.insert({nx, ny});
-                    }
-                }
-            }
-        }
+        litArea |= around(prevPos);
     }
-    
-    // Add cells around current player positions (to draw new light) – restrict to dark zones
     for (const auto& player : players) {
         if (player.getRoomIdx() != roomIdx) continue;
-        Point pos = player.getPosition();
-        for (int dy = -updateRadius; dy <= updateRadius; ++dy) {
-            for (int dx = -updateRadius; dx <= updateRadius; ++dx) {
-                int nx = pos.getX() + dx;
-                int ny = pos.getY() + dy;
-                if (nx >= 0 && nx < Screen::MAX_X && ny >= 0 && ny < Screen::MAX_Y) {
-                    Point q(nx, ny);
-                    if (isInDarkZone(screen, q)) {
-                        cellsToUpdate.insert({nx, ny});
-                    }
-                }
-            }
-        }
-        // Ensure the player position itself is always updated (even if not inside dark zone)
-        cellsToUpdate.insert({pos.getX(), pos.getY()});
+        litArea |= around(player.getPosition());
     }
-
-    // Add cells around extra light sources (e.g., dropped torches) – restrict to dark zones
     for (const auto& src : extraLightSources) {
-        for (int dy = -updateRadius; dy <= updateRadius; ++dy) {
-            for (int dx = -updateRadius; dx <= updateRadius; ++dx) {
-                int nx = src.getX() + dx;
-                int ny = src.getY() + dy;
-                if (nx >= 0 && nx < Screen::MAX_X && ny >= 0 && ny < Screen::MAX_Y) {
-                    Point q(nx, ny);
-                    if (isInDarkZone(screen, q)) {
-                        cellsToUpdate.insert({nx, ny});
-                    }
-                }
-            }
-        }
-        // Ensure the light source cell itself is updated
-        cellsToUpdate.insert({src.getX(), src.getY()});
+        litArea |= around(src);
     }
+    CellMask cellsToUpdate = litArea & screen.getDarkMask();
     
-    // Also explicitly add previous positions themselves to clear player ghost
+    // The player positions, light sources and previous positions themselves are always updated
+    // (even outside dark zones) to draw the player and clear its ghost
+    for (const auto& player : players) {
+        if (player.getRoomIdx() == roomIdx) cellsToUpdate.set(player.getPosition());
+    }
+    for (const auto& src : extraLightSources) {
+        cellsToUpdate.set(src);
+    }
     for (const auto& prevPos : previousPositions) {
-        if (prevPos.getX() >= 0 && prevPos.getX() < Screen::MAX_X && 
-            prevPos.getY() >= 0 && prevPos.getY() < Screen::MAX_Y) {
-            cellsToUpdate.insert({prevPos.getX(), prevPos.getY()});
-        }
+        cellsToUpdate.set(prevPos);
     }
     
-    // Build player position map for this room
-    std::map<std::pair<int,int>, wchar_t> playerSymbolMap;
+    // Cells with a player of this room; their symbol is looked up among the (few) players.
+    // Nothing here allocates: this runs every tick a player moves in a dark room.
+    CellMask playerCells;
     for (const auto& player : players) {
-        if (player.getRoomIdx() == roomIdx) {
+        if (player.getRoomIdx() == roomIdx) playerCells.set(player.getPosition());
+    }
+    auto playerSymbolAt = [&](int x, int y) {
+        wchar_t symbol = 0;
+        for (const auto& player : players) {
+            if (player.getRoomIdx() != roomIdx) continue;
             Point pos = player.getPosition();
-            auto key = std::make_pair(pos.getX(), pos.getY());
-            if (playerSymbolMap.count(key)) {
-                playerSymbolMap[key] = L'O'; // Overlap
-            } else {
-                playerSymbolMap[key] = player.getSymbol();
-            }
+            if (pos.getX() != x || pos.getY() != y) continue;
+            if (symbol != 0) return L'O'; // Overlap
+            symbol = player.getSymbol();
         }
-    }
+        return symbol;
+    };
     
     // Update each affected cell
-    for (const auto& cell : cellsToUpdate) {
-        Point p(cell.first, cell.second);
+    cellsToUpdate.forEach([&](int x, int y) {
+        Point p(x, y);
         wchar_t ch;
         
         // Check if player is at this position
-        auto it = playerSymbolMap.find(cell);
-        if (it != playerSymbolMap.end()) {
-            ch = it->second;
+        if (playerCells.test(x, y)) {
+            ch = playerSymbolAt(x, y);
         } else if (isInDarkZone(screen, p)) {
             // In dark zone - apply darkness effect
             ch = getDisplayChar(screen, p, players, roomIdx);
@@ -429,5 +332,5 @@ void DarkRoomManager::updateDarknessAroundPlayers(const Screen& screen, const st
         }
         
         buffer.setChar(p.getX(), p.getY(), ch);
-    }
+    });
 }
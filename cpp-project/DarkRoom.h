@@ -27,6 +27,8 @@ public:
     static constexpr int MEDIUM_SHADE_RADIUS = 8;  // ▒ at this distance
     static constexpr int HEAVY_SHADE_RADIUS = 9;   // ▓ at this distance
     // Beyond heavy shade radius = full darkness █
+    static constexpr int FULL_DARK_LEVEL = 4;
+    static constexpr int DROPPED_TORCH_RADIUS = 4; // A torch lying on the floor fully lights the 9x9 square around it
     
     // Check if a point is in any dark zone of the given screen
     static bool isInDarkZone(const Screen& screen, const Point& p);
@@ -42,16 +44,16 @@ public:
                                    const std::vector<Player>& players, int currentRoomIdx);
     
     // Draw the screen with darkness overlay (includes player drawing to prevent flicker)
-    static void drawWithDarkness(const Screen& screen, const std::vector<Player>& players, int roomIdx);
+    static void drawWithDarkness(ScreenBuffer& buffer, const Screen& screen, const std::vector<Player>& players, int roomIdx);
     
     // Update only the cells affected by player movement (much faster than full redraw)
     // Call this every frame instead of drawWithDarkness for smooth performance
-    static void updateDarknessAroundPlayers(const Screen& screen, const std::vector<Player>& players, 
+    static void updateDarknessAroundPlayers(ScreenBuffer& buffer, const Screen& screen, const std::vector<Player>& players, 
                                              int roomIdx, const std::vector<Point>& previousPositions,
                                              const std::vector<Point>& extraLightSources = {});
     
     // Refresh a single cell with darkness consideration
-    static void refreshCellWithDarkness(const Screen& screen, const Point& p,
+    static void refreshCellWithDarkness(ScreenBuffer& buffer, const Screen& screen, const Point& p,
                                          const std::vector<Player>& players, int roomIdx);
     
     // Check if the room has any dark zones
@@ -69,11 +71,16 @@ public:
     static int getDarknessLevel(const Point& pos, const std::vector<Player>& players, int roomIdx);
     
 private:
+    friend class Lightmap;
+
     // Calculate distance between two points (using maximum of dx and dy for circular-ish light)
     static int calculateDistance(const Point& a, const Point& b);
     
     // Get the darkness character for a given darkness level
     static wchar_t getDarknessChar(int level);
+
+    // Darkness level at a distance from a held torch
+    static int levelFromDistance(int dist);
     
     // Check if any player in the room is holding a torch
     static bool anyPlayerHoldsTorch(const std::vector<Player>& players, int roomIdx);
@@ -81,10 +88,6 @@ private:
     // Find closest torch-holding player distance to a point
     static int closestTorchDistance(const Point& pos, const std::vector<Player>& players, int roomIdx);
     
-    // Find closest dropped torch distance to a point
-    static int closestDroppedTorchDistance(const Point& pos, const Screen& screen);
-    
-    // Find minimum distance to any light source (held or dropped torch)
-    static int closestLightSourceDistance(const Point& pos, const std::vector<Player>& players, 
-                                           int roomIdx, const Screen& screen);
+    // Darkness level at a position from all light sources (held or dropped torches), via the screen's lightmap
+    static int lightLevel(const Point& pos, const std::vector<Player>& players, int roomIdx, const Screen& screen);
 };
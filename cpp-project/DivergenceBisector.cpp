@@ -0,0 +1,316 @@
+#include "DivergenceBisector.h"
+#include "Game.h"
+#include "FileParser.h"
+#include "Keyframe.h"
+#include "Platform.h"
+#include "Screen.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <thread>
+
+namespace {
+
+std::string glyphText(wchar_t ch) {
+    std::ostringstream oss;
+    if (ch >= 0x20 && ch < 0x7F) {
+        oss << "'" << (char)ch << "' ";
+    }
+    oss << "U+" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << (unsigned int)ch;
+    return oss.str();
+}
+
+template <typename T>
+void diffField(std::ostream& out, const std::string& label, const T& a, const T& b) {
+    if (a != b) {
+        out << "  " << label << ": " << a << " -> " << b << "\n";
+    }
+}
+
+// The screens of a side as they are in `state`: the level files plus the recorded changes
+std::vector<Screen> applyModifications(std::vector<Screen> screens, const Keyframe& state) {
+    for (const auto& kv : state.getScreenModifications()) {
+        if (kv.first < 0 || kv.first >= (int)screens.size()) continue;
+        for (const auto& tup : kv.second) {
+            screens[kv.first].setCharAt(Point(std::get<0>(tup), std::get<1>(tup)), std::get<2>(tup));
+        }
+    }
+    return screens;
+}
+
+// The original grids of two level packs: a line naming the rooms whose cells differ, empty when the same
+std::string layoutDifference(const std::vector<Screen>& screensA, const std::vector<Screen>& screensB) {
+    std::ostringstream oss;
+    if (screensA.size() != screensB.size()) {
+        oss << "Level packs differ: " << screensA.size() << " rooms vs " << screensB.size() << " rooms\n";
+    }
+    size_t cells = 0;
+    std::string rooms;
+    for (size_t r = 0; r < (std::min)(screensA.size(), screensB.size()); ++r) {
+        size_t roomCells = 0;
+        for (int y = 0; y < Screen::MAX_Y; ++y) {
+            for (int x = 0; x < Screen::MAX_X; ++x) {
+                if (screensA[r].getCharAt(Point(x, y)) != screensB[r].getCharAt(Point(x, y))) ++roomCells;
+            }
+        }
+        if (roomCells > 0) {
+            rooms += (rooms.empty() ? "" : ", ") + std::to_string(r);
+            cells += roomCells;
+        }
+    }
+    if (cells > 0) {
+        bool oneRoom = rooms.find(',') == std::string::npos;
+        oss << "Level packs differ: " << cells << (cells == 1 ? " cell" : " cells") << " in the original grids ("
+            << (oneRoom ? "room " : "rooms ") << rooms << ")\n";
+    }
+    return oss.str();
+}
+
+std::string bombText(const Keyframe::BombEntry& b) {
+    std::ostringstream oss;
+    oss << "room " << b.roomIdx << " (" << b.x << "," << b.y << ") " << b.ticksLeft << " ticks";
+    return oss.str();
+}
+
+} // namespace
+
+std::string DivergenceBisector::Side::describe() const {
+    std::string text = executable.empty() ? "this build" : executable;
+    text += levelDir.empty() ? ", default screens" : ", screens from " + levelDir;
+    return text;
+}
+
+bool DivergenceBisector::probe(const Side& side, const std::string& recordingDir, int cycle, Keyframe& state) {
+    if (side.executable.empty()) {
+        Game game(GameMode::LoadSilent, recordingDir, side.levelDir);
+        if (!game.isLoaded()) return false;
+        int firstMismatchCycle = -1;
+        game.runSegment(nullptr, cycle, state, firstMismatchCycle);
+        return true;
+    }
+
+    // Another build replays the same recording and prints its state in keyframe form
+    std::string command;
+    if (!recordingDir.empty()) {
+        command = "cd " + Platform::quoteArgument(recordingDir) + " && ";
+    }
+    command += Platform::quoteArgument(side.executable) + " -load -silent -dumpstate " + std::to_string(cycle);
+
+    std::string output;
+    if (!Platform::runCommand(command, output)) {
+        FileParser::reportError("Could not run " + side.executable);
+        return false;
+    }
+    size_t start = output.find("KEYFRAME ");
+    if (start == std::string::npos || !state.read(output.substr(start))) {
+        FileParser::reportError("No readable state from " + side.executable + " (does it support -dumpstate?)");
+        return false;
+    }
+    return true;
+}
+
+bool DivergenceBisector::dumpState(int cycle, std::ostream& out) {
+    Keyframe state;
+    if (!probe(Side(), "", cycle, state)) return false;
+    state.write(out);
+    out << std::flush;
+    return true;
+}
+
+void DivergenceBisector::printDiff(std::ostream& out, const Keyframe& a, const Keyframe& b,
+                                   const std::vector<Screen>& screensA, const std::vector<Screen>& screensB) {
+    diffField(out, "Cycle", a.getCycle(), b.getCycle());
+    diffField(out, "Steps consumed", a.getStepIndex(), b.getStepIndex());
+    diffField(out, "Visible room", a.getVisibleRoomIdx(), b.getVisibleRoomIdx());
+    diffField(out, "Hearts", a.getHeartsCount(), b.getHeartsCount());
+    diffField(out, "Points", a.getPointsCount(), b.getPointsCount());
+    diffField(out, "Final room focus ticks", a.getFinalRoomFocusTicks(), b.getFinalRoomFocusTicks());
+
+    // Cells changed while playing on either side. Only these are compared, deliberately: the
+    // keyframes record changes, not layouts, so the bisector looks for where play diverged
+    // (run() reports layout differences up front). The per-cycle state hash of a game does
+    // cover every cell.
+    std::vector<Screen> worldA = applyModifications(screensA, a);
+    std::vector<Screen> worldB = applyModifications(screensB, b);
+    std::set<std::tuple<int, int, int>> changedCells;
+    for (const Keyframe* state : { &a, &b }) {
+        for (const auto& kv : state->getScreenModifications()) {
+            for (const auto& tup : kv.second) {
+                changedCells.insert(std::make_tuple(kv.first, std::get<1>(tup), std::get<0>(tup)));
+            }
+        }
+    }
+    size_t cellDiffs = 0;
+    for (const auto& cell : changedCells) {
+        int r = std::get<0>(cell);
+        Point p(std::get<2>(cell), std::get<1>(cell));
+        if (r < 0 || r >= (int)worldA.size() || r >= (int)worldB.size()) continue;
+        wchar_t chA = worldA[r].getCharAt(p);
+        wchar_t chB = worldB[r].getCharAt(p);
+        if (chA != chB) {
+            out << "  Room " << r << " (" << p.getX() << "," << p.getY() << "): " << glyphText(chA) << " -> " << glyphText(chB) << "\n";
+            ++cellDiffs;
+        }
+    }
+
+    // Players, field by field
+    const auto& playersA = a.getPlayers();
+    const auto& playersB = b.getPlayers();
+    for (size_t i = 0; i < (std::max)(playersA.size(), playersB.size()); ++i) {
+        std::string name = "Player " + std::to_string(i + 1);
+        if (i >= playersA.size() || i >= playersB.size()) {
+            out << "  " << name << " only on side " << (i < playersA.size() ? "A" : "B") << "\n";
+            continue;
+        }
+        const auto& pa = playersA[i];
+        const auto& pb = playersB[i];
+        diffField(out, name + " room", pa.roomIdx, pb.roomIdx);
+        diffField(out, name + " x", pa.x, pb.x);
+        diffField(out, name + " y", pa.y, pb.y);
+        diffField(out, name + " diffX", pa.diffX, pb.diffX);
+        diffField(out, name + " diffY", pa.diffY, pb.diffY);
+        diffField(out, name + " carried", glyphText((wchar_t)(unsigned char)pa.carried), glyphText((wchar_t)(unsigned char)pb.carried));
+        diffField(out, name + " action requested", pa.actionRequested, pb.actionRequested);
+        diffField(out, name + " spring room", pa.springRoomIdx, pb.springRoomIdx);
+        diffField(out, name + " spring", pa.springIdx, pb.springIdx);
+        diffField(out, name + " spring entry", pa.entryIndex, pb.entryIndex);
+        diffField(out, name + " compressed", pa.compressedCount, pb.compressedCount);
+        diffField(out, name + " boost ticks", pa.boostTicksLeft, pb.boostTicksLeft);
+        diffField(out, name + " boost speed", pa.boostSpeed, pb.boostSpeed);
+        diffField(out, name + " boost dirX", pa.boostDirX, pb.boostDirX);
+        diffField(out, name + " boost dirY", pa.boostDirY, pb.boostDirY);
+    }
+
+    // Bombs are listed in full when any of them differs
+    const auto& bombsA = a.getBombs();
+    const auto& bombsB = b.getBombs();
+    bool bombsDiffer = bombsA.size() != bombsB.size();
+    for (size_t i = 0; !bombsDiffer && i < bombsA.size(); ++i) {
+        bombsDiffer = bombText(bombsA[i]) != bombText(bombsB[i]);
+    }
+    if (bombsDiffer) {
+        for (const auto& bomb : bombsA) out << "  Bomb A: " << bombText(bomb) << "\n";
+        for (const auto& bomb : bombsB) out << "  Bomb B: " << bombText(bomb) << "\n";
+    }
+
+    for (size_t i = 0; i < (std::min)(a.getSwitches().size(), b.getSwitches().size()); ++i) {
+        const auto& sa = a.getSwitches()[i];
+        const auto& sb = b.getSwitches()[i];
+        diffField(out, "Switch " + std::to_string(sa.switchIdx) + " in room " + std::to_string(sa.roomIdx), sa.on, sb.on);
+    }
+    for (size_t i = 0; i < (std::min)(a.getDoors().size(), b.getDoors().size()); ++i) {
+        const auto& da = a.getDoors()[i];
+        const auto& db = b.getDoors()[i];
+        std::string name = "Door " + std::to_string(da.doorIdx) + " in room " + std::to_string(da.roomIdx);
+        diffField(out, name + " open", da.open, db.open);
+        diffField(out, name + " keys", da.keysInserted.size(), db.keysInserted.size());
+    }
+
+    out << "  (" << cellDiffs << " cells differ)\n";
+}
+
+bool DivergenceBisector::run(const std::string& recordingDir, const Side& a, const Side& b) {
+    // Another build loads the screens it finds next to the recording; it cannot be given a level pack
+    for (const Side* side : { &a, &b }) {
+        if (!side->executable.empty() && !side->levelDir.empty()) {
+            FileParser::reportError("-levels cannot be combined with -build (the other build uses its own screens)");
+            return false;
+        }
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    int probes = 0;
+
+    // Both sides of a probe run at the same time
+    auto probeBoth = [&](int cycle, Keyframe& stateA, Keyframe& stateB) {
+        bool okA = false, okB = false;
+        std::thread sideB([&]() { okB = probe(b, recordingDir, cycle, stateB); });
+        okA = probe(a, recordingDir, cycle, stateA);
+        sideB.join();
+        ++probes;
+        return okA && okB;
+    };
+
+    std::ostringstream oss;
+    // A failed probe ends the search: nothing past it is known
+    auto probeFailed = [&](int cycle, int lo, int hi) {
+        oss << "Probe failed at cycle " << cycle << " (bisection interval " << lo << ".." << hi << ")\n";
+        oss << "==========================================\n";
+        std::cout << oss.str() << std::flush;
+        return false;
+    };
+
+    oss << "\n========== DIVERGENCE BISECTION ==========\n";
+    oss << "Side A: " << a.describe() << "\n";
+    oss << "Side B: " << b.describe() << "\n";
+
+    // Differences in cells neither replay touches never show up below, so the layouts are compared first
+    std::vector<Screen> screensA = Screen::loadScreensFromFiles(a.levelDir);
+    std::vector<Screen> screensB = Screen::loadScreensFromFiles(b.levelDir);
+    oss << layoutDifference(screensA, screensB);
+    oss << "------------------------------------------\n";
+
+    // Probing past the end yields the state each replay ended in
+    Keyframe stateA, stateB;
+    if (!probeBoth(INT_MAX, stateA, stateB)) {
+        oss << "Could not replay the recording on both sides\n";
+        oss << "==========================================\n";
+        std::cout << oss.str() << std::flush;
+        return false;
+    }
+    if (stateA.hash() == stateB.hash()) {
+        oss << "No divergence: both replays end in the same state at cycle " << stateA.getCycle() << "\n";
+        oss << "==========================================\n";
+        std::cout << oss.str() << std::flush;
+        return true;
+    }
+
+    // Invariant: states equal at the start of cycle lo, different at the start of cycle hi
+    int lo = -1;
+    int hi = (std::max)(stateA.getCycle(), stateB.getCycle()) + 1;
+    Keyframe probeA, probeB;
+    if (!probeBoth(0, probeA, probeB)) {
+        return probeFailed(0, 0, hi);
+    }
+    if (probeA.hash() == probeB.hash()) {
+        lo = 0;
+    } else {
+        hi = 0;
+        stateA = probeA;
+        stateB = probeB;
+    }
+    while (hi - lo > 1) {
+        int mid = lo + (hi - lo) / 2;
+        if (!probeBoth(mid, probeA, probeB)) {
+            return probeFailed(mid, lo, hi);
+        }
+        if (probeA.hash() == probeB.hash()) {
+            lo = mid;
+        } else {
+            hi = mid;
+            stateA = probeA;
+            stateB = probeB;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    if (lo < 0) {
+        oss << "States already differ at cycle 0\n";
+    } else {
+        oss << "First divergence at cycle " << hi << " (states equal at the start of cycle " << lo
+            << ", different at the start of cycle " << hi << ")\n";
+    }
+    oss << "Probes: " << probes << "  Time: " << std::fixed << std::setprecision(3) << seconds << " s\n";
+    oss << "------------------------------------------\n";
+    oss << "Differences (A -> B):\n";
+    printDiff(oss, stateA, stateB, screensA, screensB);
+    oss << "==========================================\n";
+    std::cout << oss.str() << std::flush;
+    return false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <ostream>
+
+class Keyframe;
+class Screen;
+
+// Finds the first cycle at which two replays of the same recording diverge.
+// A side is this build with a level pack, or another build of the game run as a
+// separate process (-dumpstate). Each probe replays silently up to a cycle and compares
+// the full state there (see Keyframe), the probes binary-search for the first cycle whose
+// states differ, and the two states at that cycle are printed cell by cell.
+class DivergenceBisector {
+public:
+    struct Side {
+        std::string levelDir;    // Screens of this side (empty = default search)
+        std::string executable;  // Other build to run (empty = this build, in-process)
+
+        std::string describe() const;
+    };
+
+    // State at the start of `cycle`, or where the replay ended if that came first.
+    // recordingDir "" = current directory. Returns false if the side could not be run.
+    static bool probe(const Side& side, const std::string& recordingDir, int cycle, Keyframe& state);
+
+    // -dumpstate: print the state at `cycle` of the recording in the current directory
+    static bool dumpState(int cycle, std::ostream& out);
+
+    // Print what differs between the states of side a and side b
+    static void printDiff(std::ostream& out, const Keyframe& a, const Keyframe& b,
+                          const std::vector<Screen>& screensA, const std::vector<Screen>& screensB);
+
+    // Bisect the recording in recordingDir and print the report. Returns true if the replays never diverge.
+    static bool run(const std::string& recordingDir, const Side& a, const Side& b);
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Point.h"
+
+// Cell -> entity lookup for one room: for each kind of entity, which entry of the room's
+// Screen::Data list covers each cell. Makes every findAt a single array load.
+// Screen rebuilds it whenever the lists are rescanned. (Obstacles move, so they have their own
+// world-wide map in ObstacleRegistry.)
+class EntityIndex {
+public:
+    enum Kind { Spring, Switch, PressureButton, SpecialDoor, KIND_COUNT };
+
+    static constexpr int WIDTH = 80;
+    static constexpr int HEIGHT = 25;
+
+    // Index into the list of that kind, -1 if no entity of that kind covers the cell
+    int get(Kind kind, const Point& p) const {
+        if (p.getX() < 0 || p.getX() >= WIDTH || p.getY() < 0 || p.getY() >= HEIGHT) return -1;
+        return (int)slots_[kind][p.getY() * WIDTH + p.getX()] - 1;
+    }
+
+    // Entry of list covering p, nullptr if none
+    template <class T>
+    T* find(Kind kind, std::vector<T>& list, const Point& p) const {
+        int idx = get(kind, p);
+        return (idx >= 0 && idx < (int)list.size()) ? &list[idx] : nullptr;
+    }
+
+    // Assign the cell to entry index unless an earlier entry already covers it
+    // (findAt used to return the first entry in list order)
+    void add(Kind kind, const Point& p, int index) {
+        if (p.getX() < 0 || p.getX() >= WIDTH || p.getY() < 0 || p.getY() >= HEIGHT) return;
+        uint16_t& slot = slots_[kind][p.getY() * WIDTH + p.getX()];
+        if (slot == 0) slot = (uint16_t)(index + 1);
+    }
+
+    void clear(Kind kind) { slots_[kind].fill(0); }
+
+private:
+    std::array<std::array<uint16_t, WIDTH * HEIGHT>, KIND_COUNT> slots_{};  // Entry index + 1, 0 = none
+};
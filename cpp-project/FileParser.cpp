@@ -4,15 +4,15 @@
 #include <sstream>
 #include <filesystem>
 #include <algorithm>
-#include <windows.h>
+#include "Platform.h"
 
 namespace fs = std::filesystem;
 
 // We want to say thank you to ChatGPT for helping with the implementation of this file.
 
-// Static member initialization
-ErrorCallback FileParser::s_errorHandler = FileParser::defaultErrorHandler;
-bool FileParser::s_hasErrors = false;
+// Error state is kept per thread so worker threads never share it
+thread_local ErrorCallback FileParser::s_errorHandler = FileParser::defaultErrorHandler;
+thread_local bool FileParser::s_hasErrors = false;
 
 void FileParser::defaultErrorHandler(const std::string& message) {
     std::cerr << "Error: " << message << std::endl;
@@ -38,13 +38,7 @@ void FileParser::clearErrors() {
 }
 
 std::string FileParser::getExeDirectory() {
-    wchar_t buffer[MAX_PATH];
-    DWORD len = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
-    if (len == 0) {
-        return fs::current_path().string();
-    }
-    fs::path exePath(buffer);
-    return exePath.parent_path().string();
+    return Platform::getExeDirectory();
 }
 
 std::optional<std::string> FileParser::findFile(const std::string& filename) {
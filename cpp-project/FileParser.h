@@ -16,13 +16,13 @@ public:
     // Default error handler (prints to stderr)
     static void defaultErrorHandler(const std::string& message);
     
-    // Set global error handler
+    // Set the error handler (per thread, so parallel games report independently)
     static void setErrorHandler(ErrorCallback handler);
     
     // Report an error through the current handler
     static void reportError(const std::string& message);
     
-    // Check if any errors occurred during parsing
+    // Check if any errors occurred during parsing (on the calling thread)
     static bool hasErrors();
     
     // Clear error state
@@ -56,6 +56,6 @@ public:
     static bool startsWith(const std::string& str, const std::string& prefix);
     
 private:
-    static ErrorCallback s_errorHandler;
-    static bool s_hasErrors;
+    static thread_local ErrorCallback s_errorHandler;
+    static thread_local bool s_hasErrors;
 };
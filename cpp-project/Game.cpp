@@ -1,17 +1,20 @@
-﻿#include <conio.h>
-#include <windows.h>
-#include <queue>
+﻿#include <queue>
 #include <set>
 #include <vector>
 #include <string>
 #include <utility>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <climits>
 
 #include "Game.h"
 #include "Board.h"
 #include "ScreenBuffer.h"
 #include "utils.h"
+#include "Platform.h"
 #include "Glyph.h"
 #include "Menu.h"
 #include "RoomConnections.h"
@@ -23,6 +26,8 @@
 #include "DarkRoom.h"
 #include "GameRecorder.h"
 #include "GameState.h"
+#include "Keyframe.h"
+#include "StateHash.h"
 
 using std::vector;
 using std::string;
@@ -56,7 +61,8 @@ Game::Game() : visibleRoomIdx(0), isRunning(true), gameMode(GameMode::Normal), g
     initGame(); 
 }
 
-Game::Game(GameMode mode) : visibleRoomIdx(0), isRunning(true), gameMode(mode), gameCycle(0), inPauseMenu(false) { 
+Game::Game(GameMode mode, const std::string& recordingDir, const std::string& levelDir)
+    : visibleRoomIdx(0), isRunning(true), gameMode(mode), gameCycle(0), levelDirectory(levelDir), inPauseMenu(false) { 
     initGame(); 
     
     // Initialize recorder for save/load modes
@@ -66,7 +72,7 @@ Game::Game(GameMode mode) : visibleRoomIdx(0), isRunning(true), gameMode(mode),
     }
     else if (mode == GameMode::Load || mode == GameMode::LoadSilent) {
         recorder = std::make_unique<GameRecorder>();
-        if (!recorder->initForLoad()) {
+        if (!recorder->initForLoad(recordingDir)) {
             FileParser::reportError("Failed to load game recording files");
             isRunning = false;
         }
@@ -78,9 +84,18 @@ Game::Game(const GameStateData& savedState, GameMode mode)
     initGame(savedState);
 }
 
+Game::~Game() {
+    for (auto& pair : riddlesByPosition) delete pair.second;
+}
+
 void Game::initGame() {
 
-world = Screen::loadScreensFromFiles();
+// All drawing goes through the board; silent replays get one that renders nothing
+if (!board) {
+    board = Board::create(gameMode == GameMode::LoadSilent, screenBuffer);
+}
+
+world = Screen::loadScreensFromFiles(levelDirectory);
  
 if (world.empty()) { 
     FileParser::reportError("Cannot start game: No level screens could be loaded.");
@@ -92,6 +107,7 @@ if (world.empty()) {
 // Capture original state of all screens for tracking modifications
 for (auto& screen : world) {
     screen.captureOriginalState();
+    screen.setBoard(board.get());
 }
     
 // Store screen file names for recording
@@ -113,7 +129,8 @@ for (auto& screen : world) {
     // Load room connections from screen metadata
     roomConnections.loadFromScreens(world);
 
-    Screen::scanAllScreens(world, roomConnections, riddlesByPosition, legend);
+    Screen::scanAllScreens(world, roomConnections, riddlesByPosition, legend, obstacles);
+    checkAllDoors();
 
     players.push_back(Player(Point(53, 19), "wdxase", Glyph::First_Player, 0));
     players.push_back(Player(Point(63, 19), "ilmjko", Glyph::Second_Player, 0));
@@ -188,22 +205,60 @@ void Game::initGame(const GameStateData& savedState) {
   ||    (__)
   ||w--||                           */
 
-void Game::runApp(GameMode mode) {
+void Game::runApp(GameMode mode, int seekCycle, const std::string& flushStatsPath) {
 
 // Initialize console settings once at the start of the application
 try {
-    SetConsoleOutputCP(65001); 
     setConsoleFont(); 
     if (mode != GameMode::LoadSilent) {
         hideCursor();
+        Platform::clearConsole();  // Once; from here on every screen is drawn through a ScreenBuffer
     }
 } catch (...) {
     FileParser::reportError("Warning: Could not initialize console settings");
 }
 
+// Flush statistics of the games played below (silent replays never flush): one file, one header,
+// the rows of each game numbered from 1 as its cycles restart at 0
+std::ofstream flushStats;
+int gamesLogged = 0;
+if (!flushStatsPath.empty() && mode != GameMode::LoadSilent) {
+    flushStats.open(flushStatsPath);
+    if (!flushStats) {
+        FileParser::reportError("Cannot write flush statistics to: " + flushStatsPath);
+    } else {
+        flushStats << "game,cycle,rows_scanned,rows_written,cells_changed,bytes,write_calls,microseconds\n";
+    }
+}
+
 // Handle load mode - run directly without menu
-if (mode == GameMode::Load || mode == GameMode::LoadSilent) {
+if (mode == GameMode::LoadSilent) {
     Game game(mode);
+    if (seekCycle >= 0) {
+        game.seekTo(seekCycle);
+    }
+    if (game.isRunning) {
+        std::string verificationReport;
+        int firstMismatchCycle = -1;
+        bool passed = game.runVerification(verificationReport, firstMismatchCycle);
+
+        // Print verification report
+        std::cout << verificationReport;
+
+        if (passed) {
+            std::cout << "\n*** TEST PASSED ***\n" << std::endl;
+        } else {
+            std::cout << "\n*** TEST FAILED ***\n" << std::endl;
+        }
+    }
+    return;
+}
+if (mode == GameMode::Load) {
+    Game game(mode);
+    if (flushStats.is_open()) game.logFlushStats(flushStats, ++gamesLogged);
+    if (seekCycle >= 0) {
+        game.seekTo(seekCycle);
+    }
     if (game.isRunning) {
         game.start();
     }
@@ -211,10 +266,11 @@ if (mode == GameMode::Load || mode == GameMode::LoadSilent) {
 }
 
 bool exitProgram = false;
+ScreenBuffer menuBuffer;  // Menus draw into their own buffer, each Game has its own
 
 while (!exitProgram) {
 
-    MenuAction action = Menu::showStartMenu();
+    MenuAction action = Menu::showStartMenu(menuBuffer);
         switch (action) {
 
             case MenuAction::NewGame: {
@@ -222,33 +278,37 @@ while (!exitProgram) {
                 if (!game.isRunning) {
                     // Game failed to initialize, show error and return to menu
                     std::cerr << "Press any key to return to menu..." << std::endl;
-                    (void)_getch();
+                    (void)Platform::readKey();
+                    menuBuffer.invalidate();  // The messages were written around the buffer
                 } else {
+                    if (flushStats.is_open()) game.logFlushStats(flushStats, ++gamesLogged);
                     game.start();
                 }
                 break;
             }
             
             case MenuAction::LoadSavedGame: {
-                std::string saveFilePath = Menu::showLoadDialog();
+                std::string saveFilePath = Menu::showLoadDialog(menuBuffer);
                 if (!saveFilePath.empty()) {
                     GameStateData savedState;
                     GameState stateLoader;
                     if (stateLoader.loadState(saveFilePath, savedState)) {
                         Game game(savedState, mode);
                         if (game.isRunning) {
+                            if (flushStats.is_open()) game.logFlushStats(flushStats, ++gamesLogged);
                             game.start();
                         }
                     } else {
                         std::cerr << "Failed to load saved game. Press any key..." << std::endl;
-                        (void)_getch();
+                        (void)Platform::readKey();
+                        menuBuffer.invalidate();
                     }
                 }
                 break;
             }
 
             case MenuAction::Instructions: {
-                Menu::showInstructions();
+                Menu::showInstructions(menuBuffer);
                 break;
             }
 
@@ -267,26 +327,10 @@ void Game::start() {
 
 if (!isRunning) return;
 
-bool isSilent = (gameMode == GameMode::LoadSilent);
-
-// Get the correct message lines
-std::string line1, line2, line3;
-DarkRoomManager::getDarkRoomMessage(world[visibleRoomIdx], players, visibleRoomIdx, line1, line2, line3);
-
-// Render message box content from metadata (if exists)
-if (!isSilent) {
-    world[visibleRoomIdx].renderMessageBox(line1, line2, line3);
-
-    // Use darkness-aware drawing if room has dark zones
-    if (DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
-        DarkRoomManager::drawWithDarkness(world[visibleRoomIdx], players, visibleRoomIdx);
-    } else {
-        world[visibleRoomIdx].draw();
-    }
-    refreshLegend(); 
-    drawPlayers();
-    ScreenBuffer::getInstance().flush();  // Single flush after all drawing
-}
+board->drawRoom(world[visibleRoomIdx], players, visibleRoomIdx);
+refreshLegend(); 
+drawPlayers();
+board->flush();  // Single flush after all drawing
 
 // Determine tick delay based on mode
 int tickDelay = TICK_DELAY_NORMAL;
@@ -297,7 +341,29 @@ else if (gameMode == GameMode::LoadSilent) {
     tickDelay = TICK_DELAY_SILENT;  // No delay in silent mode
 }
 
+// Silent replays skip ticks in which nothing can change
+bool elideIdleTicks = (gameMode == GameMode::LoadSilent && recorder);
+
     while (isRunning) { 
+        // A verified segment ends exactly where the next keyframe was taken
+        if (stopAtCycle >= 0 && gameCycle >= stopAtCycle) return;
+
+        // Keyframes are taken before the cycle's input so playback can resume exactly here
+        if (gameMode == GameMode::Save && recorder && gameCycle % GameRecorder::KEYFRAME_INTERVAL == 0) {
+            recorder->recordKeyframe(captureKeyframe());
+        }
+
+        // State hashes are taken at the same point, the first differing one is where a replay diverged
+        if (gameMode == GameMode::Save && recorder && gameCycle % GameRecorder::STATE_HASH_INTERVAL == 0) {
+            recorder->recordStateHash(gameCycle, computeStateHash());
+        }
+        else if (gameMode == GameMode::LoadSilent && recorder && recorder->hasStateHashesIn(gameCycle, gameCycle + 1)) {
+            recorder->checkStateHashes(gameCycle, gameCycle + 1, computeStateHash());
+        }
+
+        // Flushes from here on are logged under this cycle
+        screenBuffer.setFrameKey(gameCycle);
+
         // Handle input based on mode
         if (gameMode == GameMode::Load || gameMode == GameMode::LoadSilent) {
             handleInputFromRecorder();
@@ -306,12 +372,23 @@ else if (gameMode == GameMode::LoadSilent) {
         }
         
         if (!isRunning) break;
+
+        if (elideIdleTicks) {
+            IdleSnapshot before = captureIdleSnapshot();
+            update();
+            gameCycle++;
+            if (isRunning && wasIdleTick(before)) {
+                skipIdleTicks();
+            }
+            continue;
+        }
+
         update(); 
         
         gameCycle++;  // Increment game cycle
         
         if (tickDelay > 0) {
-            Sleep(tickDelay); 
+            Platform::sleepMs(tickDelay); 
         }
     }
     
@@ -354,26 +431,14 @@ else if (gameMode == GameMode::LoadSilent) {
         if (heartsCount <= 0 || allPlayersWon) {
              recordGameEnd(heartsCount > 0 && allPlayersWon);
         }
-        
-        std::string verificationReport;
-        bool passed = recorder->verifyResults(verificationReport);
-        
-        // Print verification report
-        std::cout << verificationReport;
-        
-        if (passed) {
-            std::cout << "\n*** TEST PASSED ***\n" << std::endl;
-        } else {
-            std::cout << "\n*** TEST FAILED ***\n" << std::endl;
-        }
-        return;  // Don't show win/lose screens in silent mode
+        return;  // Don't show win/lose screens in silent mode, runVerification compares the results
     }
     
-    if (!isSilent) {
-        cls();
+    if (board->isDisplayEnabled()) {
+        board->clearScreen();
         
         if (heartsCount <= 0) {
-            Menu::showLoseScreen();
+            Menu::showLoseScreen(screenBuffer);
         }
         else {
             // Check if both players reached final room (win condition)
@@ -386,12 +451,65 @@ else if (gameMode == GameMode::LoadSilent) {
             }
             
             if (allPlayersWon) {
-                Menu::showWinScreen();
+                Menu::showWinScreen(screenBuffer);
             }
         }
     }
-    
-    for (auto& pair : riddlesByPosition) delete pair.second;
+}
+
+void Game::setBoard(std::unique_ptr<Board> newBoard) {
+    if (!newBoard) return;
+    board = std::move(newBoard);
+    for (auto& screen : world) {
+        screen.setBoard(board.get());
+    }
+}
+
+bool Game::runVerification(std::string& report, int& firstMismatchCycle) {
+    firstMismatchCycle = -1;
+    if (!isRunning || !recorder) {
+        report = "Recording could not be loaded\n";
+        return false;
+    }
+
+    start();
+
+    firstMismatchCycle = recorder->findFirstMismatchCycle();
+    bool passed = recorder->verifyResults(report);
+
+    // The state hash pins down where the replay diverged, usually well before a result differs
+    int hashMismatchCycle = recorder->getFirstStateHashMismatchCycle();
+    if (hashMismatchCycle >= 0) {
+        report += "STATE HASH MISMATCH: world state first differs at cycle " + std::to_string(hashMismatchCycle) + "\n";
+        if (firstMismatchCycle < 0 || hashMismatchCycle < firstMismatchCycle) {
+            firstMismatchCycle = hashMismatchCycle;
+        }
+        passed = false;
+    }
+    return passed;
+}
+
+bool Game::runSegment(const Keyframe* from, int endCycle, Keyframe& endState, int& firstMismatchCycle) {
+    firstMismatchCycle = -1;
+    if (!isRunning || !recorder || gameMode != GameMode::LoadSilent) return false;
+
+    if (from) {
+        restoreKeyframe(*from);
+        recorder->seekToEvent(from->getStepIndex());
+    }
+    int startCycle = gameCycle;
+
+    stopAtCycle = endCycle;
+    start();
+    stopAtCycle = -1;
+
+    endState = captureKeyframe();
+    firstMismatchCycle = recorder->findFirstMismatchCycle(startCycle, endCycle >= 0 ? endCycle : INT_MAX);
+    int hashMismatchCycle = recorder->getFirstStateHashMismatchCycle();
+    if (hashMismatchCycle >= 0 && (firstMismatchCycle < 0 || hashMismatchCycle < firstMismatchCycle)) {
+        firstMismatchCycle = hashMismatchCycle;
+    }
+    return endCycle < 0 || gameCycle == endCycle;
 }
 
 
@@ -406,9 +524,9 @@ void Game::handlePause() {
 
     Screen pauseScreen(pauseTemplate);
 
-    cls();
-    pauseScreen.draw();
-    ScreenBuffer::getInstance().flush();
+    board->clearScreen();
+    board->drawScreen(pauseScreen);
+    board->flush();
 
     // Record ESC key press to enter pause menu
     if (recorder && gameMode == GameMode::Save) {
@@ -417,9 +535,9 @@ void Game::handlePause() {
 
     while (true) {
 
-        if (_kbhit()) {
+        if (Platform::keyPressed()) {
 
-            char key = _getch();
+            char key = (char)Platform::readKey();
 
             if (key == ESC_KEY) {
                 // Record ESC key press to exit pause menu
@@ -435,7 +553,7 @@ void Game::handlePause() {
                 if (recorder && gameMode == GameMode::Save) {
                     recorder->recordKeyPress(gameCycle, 0, key);
                 }
-                cls();
+                board->clearScreen();
                 isRunning = false;
                 return;
             }
@@ -443,38 +561,34 @@ void Game::handlePause() {
                 // If S is pressed, we handle save state.
                 handleSaveState();
                 // Redraw pause screen after save
-                cls();
-                pauseScreen.draw();
-                ScreenBuffer::getInstance().flush();
+                board->clearScreen();
+                board->drawScreen(pauseScreen);
+                board->flush();
             }
         }
 
-        Sleep(GAME_TICK_DELAY_MS);
+        Platform::sleepMs(GAME_TICK_DELAY_MS);
     }
 }
 
 void Game::handleSaveState() {
     std::string saveName;
-    if (Menu::showSaveDialog(saveName)) {
+    if (Menu::showSaveDialog(screenBuffer, saveName)) {
         GameStateData state = captureState();
         state.setSaveName(saveName);
         
         GameState saver;
         if (saver.saveState(state, saveName)) {
             // Show success message briefly
-            cls();
-            HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-            COORD pos{30, 12};
-            SetConsoleCursorPosition(hOut, pos);
-            std::cout << "Game saved successfully!";
-            Sleep(1500);
+            board->clearScreen();
+            screenBuffer.writeText(30, 12, L"Game saved successfully!");
+            board->flush();
+            Platform::sleepMs(1500);
         } else {
-            cls();
-            HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-            COORD pos{30, 12};
-            SetConsoleCursorPosition(hOut, pos);
-            std::cout << "Failed to save game!";
-            Sleep(1500);
+            board->clearScreen();
+            screenBuffer.writeText(30, 12, L"Failed to save game!");
+            board->flush();
+            Platform::sleepMs(1500);
         }
     }
 }
@@ -517,50 +631,18 @@ GameStateData Game::captureState() const {
 void Game::refreshLegend() {
     char p1Inv = players.size() > 0 ? players[0].getCarried() : NO_INVENTORY_ITEM;
     char p2Inv = players.size() > 1 ? players[1].getCarried() : NO_INVENTORY_ITEM;
-    legend.drawLegend(visibleRoomIdx, heartsCount, pointsCount, p1Inv, p2Inv);
+    board->drawLegend(legend, visibleRoomIdx, heartsCount, pointsCount, p1Inv, p2Inv);
 }
 
 void Game::drawPlayers() {
-    ScreenBuffer& buffer = ScreenBuffer::getInstance();
-    
-    // Collect positions of players in current room
-    std::vector<std::pair<Point, size_t>> playerPositions;
-    for (size_t i = 0; i < players.size(); ++i) {
-        if (players[i].getRoomIdx() == visibleRoomIdx) {
-            playerPositions.push_back({players[i].getPosition(), i});
-        }
-    }
-    
-    // Draw players, handling overlapping positions
-    std::set<std::pair<int,int>> drawnPositions;
-    for (const auto& [pos, idx] : playerPositions) {
-        auto posKey = std::make_pair(pos.getX(), pos.getY());
-        if (drawnPositions.count(posKey) == 0) {
-            // Check if another player is at the same position
-            bool overlapping = false;
-            for (const auto& [otherPos, otherIdx] : playerPositions) {
-                if (otherIdx != idx && otherPos.getX() == pos.getX() && otherPos.getY() == pos.getY()) {
-                    overlapping = true;
-                    break;
-                }
-            }
-            
-            if (overlapping) {
-                // Draw a combined symbol when players overlap
-                buffer.setChar(pos.getX(), pos.getY(), OVERLAP_ICON);
-            } else {
-                players[idx].draw();
-            }
-            drawnPositions.insert(posKey);
-        }
-    }
+    board->drawPlayers(players, visibleRoomIdx);
 }
 
 void Game::handleInput() {
 
-    if (_kbhit()) {
+    if (Platform::keyPressed()) {
 
-        char key = _getch();
+        char key = (char)Platform::readKey();
 
         // ESC opens pause menu
         if (key == ESC_KEY) { 
@@ -608,30 +690,18 @@ void Game::handleInputFromRecorder() {
     if (!recorder->hasNextEvent()) {
         // If no more input events, we should continue running until the game ends naturally
         // or until we've passed the last expected result cycle by a safe margin.
-        
-        int lastExpectedCycle = 0;
-        const auto& expected = recorder->getExpectedResults();
-        if (!expected.empty()) {
-            lastExpectedCycle = expected.back().getCycle();
-            
-            // If the last expected event is "Game ended", we should stop exactly at that cycle
-            // This handles cases where the game ends without a final key press (or key press wasn't recorded)
-            const std::string& desc = expected.back().getDescription();
-            if (desc.find("Game ended") == 0) {
-                 if (gameCycle >= lastExpectedCycle) {
-                     isRunning = false;
-                     return;
-                 }
-            }
-        }
-        
-        // If we are way past the last expected event, terminate to avoid infinite loop
-        // Give it a buffer (e.g. 200 cycles) to allow for final animations/transitions
-        if (gameCycle > lastExpectedCycle + 200) {
+        if (gameCycle >= lastPlaybackCycle()) {
             isRunning = false;
         }
         return;
     }
+
+    // A diverged replay can wait forever for an event it never consumes (a riddle answer
+    // for a riddle the player did not reach), so it also stops well after the last event
+    if (gameCycle >= (std::max)(lastPlaybackCycle(), recorder->getLastEventCycle() + 201)) {
+        isRunning = false;
+        return;
+    }
     
     // Process all events for the current cycle
     while (recorder->shouldProcessEvent(gameCycle)) {
@@ -725,6 +795,346 @@ void Game::handleInputFromRecorder() {
 
 
 
+int Game::lastPlaybackCycle() const {
+    int lastExpectedCycle = 0;
+    const auto& expected = recorder->getExpectedResults();
+    if (!expected.empty()) {
+        lastExpectedCycle = expected.back().getCycle();
+        
+        // If the last expected event is "Game ended", we should stop exactly at that cycle
+        // This handles cases where the game ends without a final key press (or key press wasn't recorded)
+        const std::string& desc = expected.back().getDescription();
+        if (desc.find("Game ended") == 0) {
+            return lastExpectedCycle;
+        }
+    }
+    
+    // If we are way past the last expected event, terminate to avoid infinite loop
+    // Give it a buffer (e.g. 200 cycles) to allow for final animations/transitions
+    return lastExpectedCycle + 201;
+}
+
+/*      (__)
+'\------(oo)    Keyframes and seeking
+  ||    (__)
+  ||w--||                      */
+
+Keyframe Game::captureKeyframe() const {
+    Keyframe frame;
+    frame.setCycle(gameCycle);
+    if (recorder) {
+        frame.setStepIndex(gameMode == GameMode::Save ? recorder->getRecordedStepCount() : recorder->getEventIndex());
+    }
+    frame.setVisibleRoomIdx(visibleRoomIdx);
+    frame.setHeartsCount(heartsCount);
+    frame.setPointsCount(pointsCount);
+    frame.setFinalRoomFocusTicks(finalRoomFocusTicks);
+    frame.setPlayerReachedFinalRoom(playerReachedFinalRoom);
+
+    for (const auto& p : players) {
+        Keyframe::PlayerEntry e;
+        Point pos = p.getPosition();
+        e.roomIdx = p.getRoomIdx();
+        e.x = pos.getX();
+        e.y = pos.getY();
+        e.diffX = pos.getDiffX();
+        e.diffY = pos.getDiffY();
+        e.carried = p.getCarried();
+        e.actionRequested = p.isActionRequested();
+        e.entryIndex = p.getEntryIndex();
+        e.compressedCount = p.getCompressedCount();
+        e.boostTicksLeft = p.getSpringBoostTicksLeft();
+        e.boostSpeed = p.getSpringBoostSpeed();
+        e.boostDirX = p.getBoostDirX();
+        e.boostDirY = p.getBoostDirY();
+
+        // The spring pointer is stored as room + index into that room's springs
+        const SpringData* spring = p.getCurrentSpring();
+        for (size_t r = 0; spring && r < world.size() && e.springIdx < 0; ++r) {
+            const auto& springs = world[r].getData().springs;
+            for (size_t i = 0; i < springs.size(); ++i) {
+                if (&springs[i] == spring) {
+                    e.springRoomIdx = (int)r;
+                    e.springIdx = (int)i;
+                    break;
+                }
+            }
+        }
+        frame.getPlayersMutable().push_back(e);
+    }
+
+    // Obstacles are listed under every room they have cells in, each room in the order a full scan
+    // finds them (by first cell in room, row, column order), as when every room kept its own copies
+    std::vector<std::pair<std::tuple<int, int, int>, const Obstacle*>> scanOrder;
+    obstacles.forEach([&scanOrder](const Obstacle& o) {
+        std::tuple<int, int, int> first(INT_MAX, INT_MAX, INT_MAX);
+        for (const ObCell& c : o.getCells()) {
+            first = (std::min)(first, std::make_tuple(c.getRoomIdx(), c.getPos().getY(), c.getPos().getX()));
+        }
+        scanOrder.push_back({ first, &o });
+    });
+    std::sort(scanOrder.begin(), scanOrder.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (size_t r = 0; r < world.size(); ++r) {
+        const Screen& screen = world[r];
+        // The message box is only written when drawing, so it is left out to keep
+        // keyframes from display and silent runs identical
+        auto mods = screen.getModifications();
+        mods.erase(std::remove_if(mods.begin(), mods.end(), [&screen](const std::tuple<int, int, wchar_t>& m) {
+            return screen.isInMessageBox(Point(std::get<0>(m), std::get<1>(m)));
+        }), mods.end());
+        if (!mods.empty()) {
+            frame.getScreenModificationsMutable()[(int)r] = mods;
+        }
+
+        for (const auto& entry : scanOrder) {
+            const auto& cells = entry.second->getCells();
+            if (std::any_of(cells.begin(), cells.end(), [r](const ObCell& c) { return c.getRoomIdx() == (int)r; })) {
+                frame.getObstaclesMutable().push_back({ (int)r, cells });
+            }
+        }
+
+        const auto& data = screen.getData();
+        for (size_t i = 0; i < data.switches.size(); ++i) {
+            frame.getSwitchesMutable().push_back({ (int)r, (int)i, data.switches[i].isOn() });
+        }
+        for (size_t i = 0; i < data.doors.size(); ++i) {
+            Keyframe::DoorEntry d;
+            d.roomIdx = (int)r;
+            d.doorIdx = (int)i;
+            d.open = data.doors[i].isOpen();
+            for (const Key& k : data.doors[i].getKeysInserted()) {
+                d.keysInserted.push_back(k.get());
+            }
+            frame.getDoorsMutable().push_back(d);
+        }
+    }
+
+    for (const auto& b : bombs) {
+        frame.getBombsMutable().push_back({ b.getRoomIdx(), b.getPosition().getX(), b.getPosition().getY(), b.getTicksLeft() });
+    }
+
+    for (const auto& kv : riddlesByPosition) {
+        frame.getRiddlesMutable().push_back({ kv.first.getRoomIdx(), kv.first.getX(), kv.first.getY(), kv.second->getPoints() });
+    }
+
+    return frame;
+}
+
+void Game::restoreKeyframe(const Keyframe& frame) {
+    gameCycle = frame.getCycle();
+    visibleRoomIdx = frame.getVisibleRoomIdx();
+    heartsCount = frame.getHeartsCount();
+    pointsCount = frame.getPointsCount();
+    finalRoomFocusTicks = frame.getFinalRoomFocusTicks();
+    inPauseMenu = false;
+
+    playerReachedFinalRoom = frame.getPlayerReachedFinalRoom();
+    playerReachedFinalRoom.resize(players.size(), false);
+
+    // Screen contents: back to the files, then the recorded changes
+    for (auto& screen : world) {
+        screen.restoreOriginalState();
+    }
+    for (const auto& kv : frame.getScreenModifications()) {
+        if (kv.first < 0 || kv.first >= (int)world.size()) continue;
+        for (const auto& tup : kv.second) {
+            world[kv.first].setCharAt(Point(std::get<0>(tup), std::get<1>(tup)), std::get<2>(tup));
+        }
+    }
+
+    // An obstacle crossing rooms is listed once per room: register it the first time
+    obstacles.reset((int)world.size());
+    for (const auto& o : frame.getObstacles()) {
+        if (o.roomIdx < 0 || o.roomIdx >= (int)world.size() || o.cells.empty()) continue;
+        if (obstacles.idAt(o.cells[0].getRoomIdx(), o.cells[0].getPos()) < 0) {
+            obstacles.add(o.cells);
+        }
+    }
+
+    for (const auto& s : frame.getSwitches()) {
+        if (s.roomIdx < 0 || s.roomIdx >= (int)world.size()) continue;
+        auto& switches = world[s.roomIdx].getDataMutable().switches;
+        if (s.switchIdx >= 0 && s.switchIdx < (int)switches.size()) {
+            switches[s.switchIdx].setOn(s.on);
+        }
+    }
+
+    for (const auto& d : frame.getDoors()) {
+        if (d.roomIdx < 0 || d.roomIdx >= (int)world.size()) continue;
+        auto& doors = world[d.roomIdx].getDataMutable().doors;
+        if (d.doorIdx >= 0 && d.doorIdx < (int)doors.size()) {
+            std::vector<Key> keys;
+            for (char k : d.keysInserted) {
+                keys.push_back(Key(k));
+            }
+            doors[d.doorIdx].setOpen(d.open);
+            doors[d.doorIdx].setKeysInserted(keys);
+        }
+    }
+    checkAllDoors();
+    resetPressureButtons();
+
+    for (const auto& r : frame.getRiddles()) {
+        auto it = riddlesByPosition.find(RiddleKey(r.roomIdx, r.x, r.y));
+        if (it != riddlesByPosition.end()) {
+            it->second->setPoints(r.points);
+        }
+    }
+
+    bombs.clear();
+    for (const auto& b : frame.getBombs()) {
+        bombs.emplace_back(Point(b.x, b.y), b.roomIdx, b.ticksLeft);
+    }
+
+    const auto& savedPlayers = frame.getPlayers();
+    for (size_t i = 0; i < savedPlayers.size() && i < players.size(); ++i) {
+        const Keyframe::PlayerEntry& e = savedPlayers[i];
+        Player& p = players[i];
+
+        Point pos(e.x, e.y);
+        pos.setDiffX(e.diffX);
+        pos.setDiffY(e.diffY);
+        p.setPosition(pos);
+        p.setRoomIdx(e.roomIdx);
+        p.setCarried(e.carried);
+        p.setActionRequested(e.actionRequested);
+
+        SpringData* spring = nullptr;
+        if (e.springRoomIdx >= 0 && e.springRoomIdx < (int)world.size()) {
+            auto& springs = world[e.springRoomIdx].getDataMutable().springs;
+            if (e.springIdx >= 0 && e.springIdx < (int)springs.size()) {
+                spring = &springs[e.springIdx];
+            }
+        }
+        p.setCurrentSpring(spring);
+        p.setEntryIndex(e.entryIndex);
+        p.setCompressedCount(e.compressedCount);
+        p.setBoostState(e.boostSpeed, e.boostTicksLeft, e.boostDirX, e.boostDirY);
+    }
+}
+
+void Game::seekTo(int targetCycle) {
+    if (!isRunning || !recorder || gameMode == GameMode::Save || targetCycle <= gameCycle) return;
+
+    // Recordings without keyframes simply simulate from the start
+    Keyframe frame;
+    if (recorder->loadKeyframe(targetCycle, frame)) {
+        restoreKeyframe(frame);
+        recorder->seekToEvent(frame.getStepIndex());
+    }
+
+    if (gameMode == GameMode::LoadSilent) {
+        // Results before the keyframe were never simulated, verify only the rest
+        recorder->discardExpectedResultsBefore(gameCycle);
+        return;
+    }
+
+    // Simulate the remaining cycles without drawing, then hand the display back
+    std::unique_ptr<Board> displayBoard = std::move(board);
+    setBoard(Board::create(true, screenBuffer));
+    while (isRunning && gameCycle < targetCycle) {
+        handleInputFromRecorder();
+        if (!isRunning) break;
+        update();
+        gameCycle++;
+    }
+    setBoard(std::move(displayBoard));
+}
+
+unsigned long long Game::computeStateHash() const {
+    // Screens keep their grid hash up to date, everything else is a few dozen values
+    unsigned long long h = StateHash::mix((unsigned long long)world.size());
+    for (const auto& screen : world) {
+        h = StateHash::combine(h, screen.getStateHash());
+        const auto& data = screen.getData();
+        for (const auto& sw : data.switches) {
+            h = StateHash::combine(h, sw.isOn() ? 1 : 0);
+        }
+        for (const auto& door : data.doors) {
+            h = StateHash::combine(h, door.isOpen() ? 1 : 0);
+            for (const auto& key : door.getKeysInserted()) {
+                h = StateHash::combine(h, (unsigned long long)(unsigned char)key.get());
+            }
+        }
+    }
+    for (const auto& p : players) {
+        h = StateHash::combine(h, p.stateHash());
+    }
+    for (const auto& b : bombs) {
+        h = StateHash::combine(h, StateHash::cell(b.getPosition().getX(), b.getPosition().getY(), (wchar_t)b.getRoomIdx()));
+        h = StateHash::combine(h, (unsigned long long)b.getTicksLeft());
+    }
+    for (int v : { visibleRoomIdx, heartsCount, pointsCount, finalRoomFocusTicks }) {
+        h = StateHash::combine(h, (unsigned long long)(long long)v);
+    }
+    for (bool reached : playerReachedFinalRoom) {
+        h = StateHash::combine(h, reached ? 1 : 0);
+    }
+    return StateHash::mix(h);
+}
+
+/*      (__)
+'\------(oo)    Idle-tick elision
+  ||    (__)
+  ||w--||              */
+
+// update() depends only on the game state (never on gameCycle itself, which is only
+// written into results). If a tick left that state untouched and no recorded event
+// arrives in between, every following tick is identical and can be skipped.
+
+Game::IdleSnapshot Game::captureIdleSnapshot() const {
+    IdleSnapshot snap;
+    for (size_t i = 0; i < players.size() && i < IDLE_MAX_PLAYERS; ++i) {
+        snap.players[i] = players[i].idleState();
+    }
+    for (const auto& screen : world) {
+        snap.worldChanges += screen.getChangeCount();
+        for (const auto& door : screen.getData().doors) {
+            snap.doorProgress += (door.isOpen() ? 1 : 0) + door.getKeysInserted().size();
+        }
+    }
+    for (size_t i = 0; i < playerReachedFinalRoom.size() && i < 32; ++i) {
+        if (playerReachedFinalRoom[i]) snap.reachedFinal |= 1u << i;
+    }
+    snap.visibleRoomIdx = visibleRoomIdx;
+    snap.heartsCount = heartsCount;
+    snap.pointsCount = pointsCount;
+    snap.eventIndex = recorder->getEventIndex();
+    snap.resultCount = recorder->getActualResultCount();
+    return snap;
+}
+
+bool Game::wasIdleTick(const IdleSnapshot& before) const {
+    // Live bombs and the final-room camera countdown change every tick
+    if (!bombs.empty() || finalRoomFocusTicks > 0) return false;
+    if (players.size() > IDLE_MAX_PLAYERS || playerReachedFinalRoom.size() > 32) return false;
+
+    IdleSnapshot after = captureIdleSnapshot();
+    if (after.worldChanges != before.worldChanges || after.doorProgress != before.doorProgress ||
+        after.reachedFinal != before.reachedFinal || after.visibleRoomIdx != before.visibleRoomIdx ||
+        after.heartsCount != before.heartsCount || after.pointsCount != before.pointsCount ||
+        after.eventIndex != before.eventIndex || after.resultCount != before.resultCount) {
+        return false;
+    }
+    return after.players == before.players;
+}
+
+void Game::skipIdleTicks() {
+    // Jump to the cycle of the next recorded event, or to where playback stops when none are left
+    int nextCycle = recorder->hasNextEvent() ? recorder->peekNextEvent().getCycle() : lastPlaybackCycle();
+    if (stopAtCycle >= 0) {
+        nextCycle = (std::min)(nextCycle, stopAtCycle);
+    }
+    // The state stays the same over the skipped cycles, so one hash covers all of their checks
+    if (nextCycle > gameCycle && recorder->hasStateHashesIn(gameCycle, nextCycle)) {
+        recorder->checkStateHashes(gameCycle, nextCycle, computeStateHash());
+    }
+    if (nextCycle > gameCycle) {
+        gameCycle = nextCycle;
+    }
+}
+
 // Recording helper methods
 void Game::recordScreenTransition(int playerIndex, int targetScreen) {
     if (recorder) {
@@ -778,8 +1188,6 @@ if (heartsCount <= 0) {
     return; 
 }
 
-bool isSilent = (gameMode == GameMode::LoadSilent);
-
 // Track player state before movement (room, position, carried) to detect relevant changes
 struct PlayerSnapshot {
     int roomIdx;
@@ -806,12 +1214,14 @@ for (const auto& p : players) {
     }
 }
 
-// Move all players
+// Move all players (each move keeps its own cell in the player masks current)
+syncPlayerOccupancy();
 for (size_t i = 0; i < players.size(); ++i) {
     auto& p = players[i];
 
     if (p.getRoomIdx() == visibleRoomIdx) {
         p.move(world[visibleRoomIdx], *this);
+        updatePlayerOccupancy(p);
     }
 
     // Always resolve riddle encounters against the player's actual room.
@@ -863,23 +1273,8 @@ if (DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
     }
 
     if (needsDarkUpdate) {
-        // Collect dropped torch positions so they contribute light/halo
-        std::vector<Point> torchSources;
-        if (torchChange) {
-            for (int y = 0; y < Screen::MAX_Y; ++y) {
-                for (int x = 0; x < Screen::MAX_X; ++x) {
-                    Point p{x, y};
-                    if (Glyph::isTorch(world[visibleRoomIdx].getCharAt(p))) {
-                        torchSources.push_back(p);
-                    }
-                }
-            }
-        }
-
-        if (!isSilent) {
-            DarkRoomManager::updateDarknessAroundPlayers(world[visibleRoomIdx], players,
-                                                         visibleRoomIdx, previousPlayerPositions, torchSources);
-        }
+        board->updateDarknessAroundPlayers(world[visibleRoomIdx], players,
+                                           visibleRoomIdx, previousPlayerPositions, torchChange);
     }
 }
     
@@ -898,15 +1293,13 @@ for (size_t i = 0; i < players.size(); ++i) {
         }
         if (!anyPlayerInCurrentRoom) {
             visibleRoomIdx = roomAfter;
-            if (!isSilent) {
-                drawEverything();
-            }
+            drawEverything();
         }
     }
 }
     
 // Draw players only if room doesn't have darkness (darkness update includes players)
-if (!isSilent && !DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
+if (!DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
     drawPlayers();
 }
     
@@ -923,13 +1316,11 @@ if (!isSilent && !DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
                 // Focus on final room for a brief period
                 visibleRoomIdx = FINAL_ROOM_INDEX;
                 finalRoomFocusTicks = FINAL_ROOM_FOCUS_TICKS;
-                if (!isSilent) {
-                    cls();
-                    world[visibleRoomIdx].draw();
-                    refreshLegend();
-                    drawPlayers();
-                    ScreenBuffer::getInstance().flush();
-                }
+                board->clearScreen();
+                board->drawScreen(world[visibleRoomIdx]);
+                refreshLegend();
+                drawPlayers();
+                board->flush();
             }
         }
     }
@@ -942,13 +1333,11 @@ if (!isSilent && !DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
             for (size_t j = 0; j < players.size(); ++j) {
                 if (players[j].getRoomIdx() != FINAL_ROOM_INDEX) {
                     visibleRoomIdx = players[j].getRoomIdx();
-                    if (!isSilent) {
-                        cls();
-                        world[visibleRoomIdx].draw();
-                        refreshLegend();
-                        drawPlayers();
-                        ScreenBuffer::getInstance().flush();
-                    }
+                    board->clearScreen();
+                    board->drawScreen(world[visibleRoomIdx]);
+                    refreshLegend();
+                    drawPlayers();
+                    board->flush();
                     break;
                 }
             }
@@ -974,88 +1363,81 @@ if (!isSilent && !DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
             // }
             
             Bomb::tickAndHandleAll(bombs, *this);
-            if (!isSilent) {
-                refreshLegend(); 
-                if (!DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
-                    drawPlayers();
-                }
-                ScreenBuffer::getInstance().flush();
+            refreshLegend(); 
+            if (!DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
+                drawPlayers();
             }
+            board->flush();
             return;
         }
     
         Bomb::tickAndHandleAll(bombs, *this);
-        if (!isSilent) {
-            refreshLegend(); 
-            if (!DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
-                drawPlayers();
-            }
-            ScreenBuffer::getInstance().flush();  // Single flush at end of update
+        refreshLegend(); 
+        if (!DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
+            drawPlayers();
         }
+        board->flush();  // Single flush at end of update
     }
 
+// Targets are only rewritten when a player steps onto or off a button
 void Game::updatePressureButtons() {
-    bool isSilent = (gameMode == GameMode::LoadSilent);
-    for (size_t roomIdx = 0; roomIdx < world.size(); ++roomIdx) {
-        Screen& screen = world[roomIdx];
-        auto& buttons = screen.getDataMutable().pressureButtons;
-        if (buttons.empty()) continue;
-
-        struct TargetState {
-            wchar_t original = Glyph::Empty;
-            bool hasOriginal = false;
-            int activeCount = 0;
-        };
-
-        std::map<std::pair<int, int>, TargetState> targets;
-
-        std::vector<Point> roomPlayers;
-        for (const auto& pl : players) {
-            if (pl.getRoomIdx() == (int)roomIdx) {
-                roomPlayers.push_back(pl.getPosition());
+    std::vector<std::pair<int, PressureButton*>> pressedNow;
+    for (const auto& pl : players) {
+        int roomIdx = pl.getRoomIdx();
+        if (roomIdx < 0 || roomIdx >= (int)world.size()) continue;
+        PressureButton* pb = PressureButton::findAt(world[roomIdx], pl.getPosition());
+        if (pb) pressedNow.push_back({ roomIdx, pb });
+    }
+    std::sort(pressedNow.begin(), pressedNow.end());
+    pressedNow.erase(std::unique(pressedNow.begin(), pressedNow.end()), pressedNow.end());
+    if (pressedNow == pressedButtons) return;
+
+    // Update the reference counts of the released and newly pressed buttons' targets...
+    std::vector<std::pair<int, int>> touched; // (room, target cell)
+    auto apply = [&](const std::vector<std::pair<int, PressureButton*>>& from,
+                     const std::vector<std::pair<int, PressureButton*>>& notIn, bool press) {
+        for (const auto& rb : from) {
+            if (std::binary_search(notIn.begin(), notIn.end(), rb)) continue;
+            auto& cells = world[rb.first].getDataMutable().pressureTargets;
+            for (int cellIdx : rb.second->getTargetCells()) {
+                if (press) cells[cellIdx].press();
+                else cells[cellIdx].release();
+                touched.push_back({ rb.first, cellIdx });
             }
         }
-
-        for (auto& ps : buttons) {
-            bool active = false;
-            Point psPos = ps.getPos();
-            for (const auto& pp : roomPlayers) {
-                if (pp.getX() == psPos.getX() && pp.getY() == psPos.getY()) {
-                    active = true;
-                    break;
-                }
-            }
-
-            for (const auto& tgt : ps.getTargets()) {
-                Point tgtPos = tgt.getPos();
-                auto key = std::make_pair(tgtPos.getX(), tgtPos.getY());
-                auto& state = targets[key];
-                if (!state.hasOriginal) {
-                    state.original = tgt.getOriginalChar();
-                    state.hasOriginal = true;
-                }
-                if (active) {
-                    state.activeCount++;
+    };
+    apply(pressedButtons, pressedNow, false);
+    apply(pressedNow, pressedButtons, true);
+    pressedButtons = std::move(pressedNow);
+
+    // ...then give those targets their glyph: empty while pressed, the original otherwise
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (const auto& [roomIdx, cellIdx] : touched) {
+        Screen& screen = world[roomIdx];
+        const PressureTargetCell& cell = screen.getData().pressureTargets[cellIdx];
+        Point p = cell.getPos();
+        wchar_t desired = (cell.getPressedCount() > 0) ? Glyph::Empty : cell.getOriginalChar();
+        if (screen.getCharAt(p) != desired) {
+            screen.setCharAt(p, desired);
+            if (visibleRoomIdx == roomIdx) {
+                if (DarkRoomManager::roomHasDarkness(screen)) {
+                    board->refreshCellWithDarkness(screen, p, players, roomIdx);
+                } else {
+                    board->refreshCell(screen, p);
                 }
             }
         }
+    }
+}
 
-        bool isVisibleRoom = (visibleRoomIdx == (int)roomIdx);
-        bool isDark = DarkRoomManager::roomHasDarkness(screen);
-
-        for (auto& kv : targets) {
-            Point p{ kv.first.first, kv.first.second };
-            wchar_t desired = (kv.second.activeCount > 0) ? Glyph::Empty : kv.second.original;
-            if (screen.getCharAt(p) != desired) {
-                screen.setCharAt(p, desired);
-                if (isVisibleRoom && !isSilent) {
-                    if (isDark) {
-                        DarkRoomManager::refreshCellWithDarkness(screen, p, players, (int)roomIdx);
-                    } else {
-                        screen.refreshCell(p);
-                    }
-                }
-            }
+// Nothing pressed: after a keyframe is restored the screens already show the targets as they were,
+// and the next update presses the buttons players stand on
+void Game::resetPressureButtons() {
+    pressedButtons.clear();
+    for (auto& screen : world) {
+        for (auto& cell : screen.getDataMutable().pressureTargets) {
+            cell.setPressedCount(0);
         }
     }
 }
@@ -1219,32 +1601,15 @@ void Game::checkAndProcessTransitions() {
 
     int focusRoom = transitions.back().targetRoom;
     visibleRoomIdx = focusRoom;
-    
-    bool isSilent = (gameMode == GameMode::LoadSilent);
-    if (!isSilent) {
-        drawEverything();
-    }
+    drawEverything();
 }
 
 void Game::drawEverything() { 
-    cls(); 
-    
-    // Get the correct message lines
-    std::string line1, line2, line3;
-    DarkRoomManager::getDarkRoomMessage(world[visibleRoomIdx], players, visibleRoomIdx, line1, line2, line3);
-
-    // Render message box content from metadata (if exists)
-    world[visibleRoomIdx].renderMessageBox(line1, line2, line3);
-    
-    // Use darkness-aware drawing if room has dark zones
-    if (DarkRoomManager::roomHasDarkness(world[visibleRoomIdx])) {
-        DarkRoomManager::drawWithDarkness(world[visibleRoomIdx], players, visibleRoomIdx);
-    } else {
-        world[visibleRoomIdx].draw();
-    }
+    board->clearScreen(); 
+    board->drawRoom(world[visibleRoomIdx], players, visibleRoomIdx);
     refreshLegend(); 
     drawPlayers();
-    ScreenBuffer::getInstance().flush();  // Single flush after all drawing
+    board->flush();  // Single flush after all drawing
 }
 
 /*      (__)
@@ -1284,10 +1649,75 @@ SpecialDoor* Game::findSpecialDoorAt(int roomIdx, const Point& p) {
 }
 
 Obstacle* Game::findObstacleAt(int roomIdx, const Point& p) {
-    return Obstacle::findAt(world[roomIdx], roomIdx, p);
+    return obstacles.findAt(roomIdx, p);
 }
 
-// Rescan obstacles across all rooms to keep obstacle instances in sync after moves
-void Game::rescanObstacles() {
-    Obstacle::scanAllObstacles(world, roomConnections);
+void Game::doorInputChanged(SpecialDoor& door) {
+    if (std::find(doorsToCheck.begin(), doorsToCheck.end(), &door) == doorsToCheck.end()) {
+        doorsToCheck.push_back(&door);
+    }
+}
+
+void Game::switchToggled(int roomIdx, const SwitchData& sw) {
+    auto& doors = world[roomIdx].getDataMutable().doors;
+    for (int doorIdx : sw.getWatchingDoors()) {
+        doorInputChanged(doors[doorIdx]);
+    }
+}
+
+std::vector<SpecialDoor*> Game::takeDoorsToCheck() {
+    std::vector<SpecialDoor*> doors;
+    doors.swap(doorsToCheck);
+    return doors;
+}
+
+// Every door gets checked once (after loading, and after restoring a keyframe): doors without
+// keys or switches to wait for open right away
+void Game::checkAllDoors() {
+    doorsToCheck.clear();
+    for (auto& screen : world) {
+        for (auto& door : screen.getDataMutable().doors) {
+            doorsToCheck.push_back(&door);
+        }
+    }
+}
+
+void Game::syncPlayerOccupancy() {
+    for (const auto& cell : occupiedCells) {
+        if (cell.first >= 0 && cell.first < (int)world.size()) {
+            world[cell.first].setPlayerAt(cell.second, false);
+        }
+    }
+    occupiedCells.clear();
+    for (const auto& p : players) {
+        int room = p.getRoomIdx();
+        if (room >= 0 && room < (int)world.size()) {
+            world[room].setPlayerAt(p.getPosition(), true);
+        }
+        occupiedCells.push_back({ room, p.getPosition() });
+    }
+}
+
+void Game::updatePlayerOccupancy(const Player& player) {
+    size_t idx = (size_t)(&player - players.data());
+    if (idx >= occupiedCells.size()) return;
+    auto& cell = occupiedCells[idx];
+    Point pos = player.getPosition();
+    int room = player.getRoomIdx();
+    if (cell.first == room && cell.second.getX() == pos.getX() && cell.second.getY() == pos.getY()) return;
+
+    // The old cell stays set if another player stands there too
+    if (cell.first >= 0 && cell.first < (int)world.size()) {
+        bool shared = false;
+        for (size_t i = 0; i < occupiedCells.size(); ++i) {
+            const auto& other = occupiedCells[i];
+            shared = shared || (i != idx && other.first == cell.first &&
+                                other.second.getX() == cell.second.getX() && other.second.getY() == cell.second.getY());
+        }
+        if (!shared) world[cell.first].setPlayerAt(cell.second, false);
+    }
+    if (room >= 0 && room < (int)world.size()) {
+        world[room].setPlayerAt(pos, true);
+    }
+    cell = { room, pos };
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <map>
 #include <memory>
@@ -11,6 +12,8 @@
 #include "RoomConnections.h"
 #include "GameRecorder.h"
 #include "GameState.h"
+#include "ScreenBuffer.h"
+#include "Board.h"
 
 constexpr int ESC_KEY = 27;
 constexpr int GAME_TICK_DELAY_MS = 90;
@@ -23,6 +26,9 @@ class Game {
     std::vector<Screen> world;
     std::vector<Player> players;
     RoomConnections roomConnections;
+    ObstacleRegistry obstacles;
+    std::vector<SpecialDoor*> doorsToCheck; // Doors whose keys or switches changed since SpecialDoor::updateAll
+    std::vector<std::pair<int, PressureButton*>> pressedButtons; // (room, button) players stood on at the last updatePressureButtons, sorted
 
     int visibleRoomIdx;
     bool isRunning;
@@ -33,29 +39,64 @@ class Game {
     std::map<RiddleKey, Riddle*> riddlesByPosition;
 
     Legend legend;
+    ScreenBuffer screenBuffer; // Back buffer of the display board
+    std::unique_ptr<Board> board; // Render target: DisplayBoard, or SilentBoard for silent replays
     
     std::vector<bool> playerReachedFinalRoom; // Track which players reached final room
     int finalRoomFocusTicks = 0; // countdown for camera focus on final room
     std::vector<Point> previousPlayerPositions; // Track previous positions for darkness updates
+    std::vector<std::pair<int, Point>> occupiedCells; // Cell of each player currently set in the screens' player masks
     
     // Game mode and recording/playback
     GameMode gameMode = GameMode::Normal;
     std::unique_ptr<GameRecorder> recorder;
     int gameCycle = 0;  // Game tick counter for recording/playback
     std::vector<std::string> loadedScreenFiles;  // Screen files used in this session
+    std::string levelDirectory;  // Where the screens are loaded from (empty = default search)
     bool inPauseMenu = false; // Track if we are in pause menu during playback
+    int stopAtCycle = -1;     // Segment verification: leave start() on reaching this cycle (-1 = never)
+
+    // Everything update() can change, captured before a tick to detect idle ticks in silent replays.
+    // Fixed size, so capturing it twice per tick never allocates.
+    static constexpr size_t IDLE_MAX_PLAYERS = 2;  // Games with more players never elide ticks
+    struct IdleSnapshot {
+        std::array<Player::IdleState, IDLE_MAX_PLAYERS> players{};
+        unsigned long long worldChanges = 0;  // Sum of Screen::getChangeCount over all rooms
+        size_t doorProgress = 0;              // Open special doors + keys inserted
+        unsigned reachedFinal = 0;            // Bit i: player i reached the final room
+        int visibleRoomIdx = 0;
+        int heartsCount = 0;
+        int pointsCount = 0;
+        size_t eventIndex = 0;
+        size_t resultCount = 0;
+    };
 
     void initGame();
     void initGame(const GameStateData& savedState);  // Initialize from saved state
 
     void handleInput();
     void handleInputFromRecorder();  // Handle input from recorded file
+    int lastPlaybackCycle() const;   // Cycle at which playback stops once all steps were consumed
     void update();
 
+    // Keyframes: full state for seeking inside recordings
+    Keyframe captureKeyframe() const;
+    void restoreKeyframe(const Keyframe& frame);
+
+    // Hash of the world state (screens, players, bombs, doors, switches) written to / checked against recordings
+    unsigned long long computeStateHash() const;
+
+    // Idle-tick elision (silent replays only)
+    IdleSnapshot captureIdleSnapshot() const;
+    bool wasIdleTick(const IdleSnapshot& before) const;
+    void skipIdleTicks();
+
     void drawPlayers();
     void drawEverything();
     void refreshLegend();
     void updatePressureButtons();
+    void resetPressureButtons();
+    void checkAllDoors();
 
     void checkAndProcessTransitions();
 
@@ -70,11 +111,38 @@ class Game {
 public:
     
     Game();
-    Game(GameMode mode);
+    // recordingDir holds adv-world.steps/.result (Load modes), levelDir the screens (empty = default search)
+    Game(GameMode mode, const std::string& recordingDir = "", const std::string& levelDir = "");
     Game(const GameStateData& savedState, GameMode mode = GameMode::Normal);  // Load from saved state
+    ~Game();
+
+    Game(const Game&) = delete;
+    Game& operator=(const Game&) = delete;
 
     void start();
-    static void runApp(GameMode mode = GameMode::Normal);
+    // flushStatsPath: CSV file for the cost of every console flush (empty = none)
+    static void runApp(GameMode mode = GameMode::Normal, int seekCycle = -1, const std::string& flushStatsPath = "");
+
+    // Log the cost of every console flush as CSV rows keyed by gameNumber and the game cycle
+    // (see ScreenBuffer::setStatsLog)
+    void logFlushStats(std::ostream& csv, int gameNumber) { screenBuffer.setStatsLog(&csv, gameNumber); }
+    const ScreenBuffer& getScreenBuffer() const { return screenBuffer; }
+
+    // Playback only: restore the latest keyframe at or before `cycle` and continue from there.
+    // Load mode simulates (without drawing) up to `cycle`; silent mode verifies from the keyframe on.
+    void seekTo(int cycle);
+
+    // Replay the loaded recording silently and compare against its expected results.
+    // Writes the verification report and the first mismatching cycle (-1 if none).
+    bool runVerification(std::string& report, int& firstMismatchCycle);
+
+    // Silent playback of one segment of the recording: from keyframe `from` (nullptr = game start)
+    // up to `endCycle` (-1 = end of recording). Writes the state reached and the first mismatching
+    // cycle among the results of the segment (-1 if none). Returns false if endCycle was not reached.
+    bool runSegment(const Keyframe* from, int endCycle, Keyframe& endState, int& firstMismatchCycle);
+
+    // False if the screens or the recording could not be loaded
+    bool isLoaded() const { return isRunning; }
 
     bool isGameLost() const { 
         return heartsCount <= 0; 
@@ -84,6 +152,12 @@ public:
     std::vector<Player>& getPlayersMutable() { return players; }
 
     Obstacle* findObstacleAt(int roomIdx, const Point& p);
+    ObstacleRegistry& getObstacles() { return obstacles; }
+
+    // A key went into door / a switch toggled: the doors involved are re-checked on the next update
+    void doorInputChanged(SpecialDoor& door);
+    void switchToggled(int roomIdx, const class SwitchData& sw);
+    std::vector<SpecialDoor*> takeDoorsToCheck();
     class SpringData* findSpringAt(int roomIdx, const Point& p);
     class SwitchData* findSwitchAt(int roomIdx, const Point& p);
     SpecialDoor* findSpecialDoorAt(int roomIdx, const Point& p);
@@ -91,8 +165,15 @@ public:
     int getVisibleRoomIdx() const { return visibleRoomIdx; }
     int getWorldSize() const { return (int)world.size(); }
     Screen& getScreen(int roomIdx) { return world[roomIdx]; }
+    const Screen& getScreen(int roomIdx) const { return world[roomIdx]; }
+    ScreenBuffer& getScreenBuffer() { return screenBuffer; }
+    Board& getBoard() { return *board; }
+
+    // Replace the render target (e.g. to render a game into a different output)
+    void setBoard(std::unique_ptr<Board> newBoard);
 
     int getTargetRoom(int fromRoom, Direction dir) const { return roomConnections.getTargetRoom(fromRoom, dir); }
+    const RoomConnections& getRoomConnections() const { return roomConnections; }
     
     void placeBomb(int roomIdx, const Point& pos, int delay = 5);
     void removeBombAt(int roomIdx, const Point& pos);
@@ -127,8 +208,11 @@ public:
         }
     }
 
-    // Rescan obstacles across all rooms to keep obstacle instances in sync after moves
-    void rescanObstacles();
+    // Move the player bits of the screens' player masks to where the players stand now.
+    // Called once per tick before the players move; updatePlayerOccupancy then follows each move.
+    void syncPlayerOccupancy();
+    // Move one player's bit to where that player stands now (the mask is read by collisions and pushes)
+    void updatePlayerOccupancy(const Player& player);
     
     // Get current game state for saving
     GameStateData captureState() const;
@@ -3,8 +3,11 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <iterator>
+#include <charconv>
 #include <ctime>
 #include <iostream>
+#include <filesystem>
 
 // GameEvent implementation
 GameEvent::GameEvent()
@@ -56,16 +59,22 @@ bool GameRecorder::initForSave(const std::vector<std::string>& screenFiles) {
     screenFiles_ = screenFiles;
     recordedEvents_.clear();
     recordedResults_.clear();
+    recordedKeyframes_.clear();
+    recordedStateHashes_.clear();
+    recordedStepCount_ = 0;
     
     return true;
 }
 
-bool GameRecorder::initForLoad() {
+bool GameRecorder::initForLoad(const std::string& directory) {
     saveMode_ = false;
+    directory_ = directory;
     currentEventIndex_ = 0;
     loadedEvents_.clear();
     expectedResults_.clear();
     actualResults_.clear();
+    expectedStateHashes_.clear();
+    firstStateHashMismatch_ = -1;
     
     if (!readStepsFile()) {
         return false;
@@ -76,6 +85,9 @@ bool GameRecorder::initForLoad() {
         // But we still need it for verification in silent mode
     }
     
+    // Recordings made before state hashes existed are verified by their results only
+    readStateHashesFile();
+    
     return true;
 }
 
@@ -89,6 +101,7 @@ void GameRecorder::recordKeyPress(int cycle, int playerIndex, char key) {
     event.setPlayerIndex(playerIndex);
     event.setKeyPressed(key);
     recordedEvents_.push_back(event);
+    recordedStepCount_++;
 }
 
 void GameRecorder::recordScreenTransition(int cycle, int playerIndex, int targetScreen) {
@@ -143,6 +156,9 @@ void GameRecorder::recordRiddleAnswer(int cycle, int playerIndex, const std::str
     event.setRiddleAnswer(answer);
     event.setRiddleCorrect(correct);
     recordedEvents_.push_back(event);
+    if (!answer.empty()) {
+        recordedStepCount_++;  // Written to the steps file as its key code
+    }
     
     // Add to results
     std::ostringstream oss;
@@ -167,13 +183,25 @@ void GameRecorder::recordGameEnd(int cycle, int score, bool isWin) {
     recordedResults_.emplace_back(cycle, oss.str());
 }
 
+void GameRecorder::recordKeyframe(const Keyframe& frame) {
+    if (!saveMode_) return;
+    recordedKeyframes_.push_back(frame);
+}
+
+void GameRecorder::recordStateHash(int cycle, unsigned long long hash) {
+    if (!saveMode_) return;
+    recordedStateHashes_.emplace_back(cycle, hash);
+}
+
 bool GameRecorder::finalizeRecording() {
     if (!saveMode_) return false;
     
     bool stepsOk = writeStepsFile();
     bool resultOk = writeResultFile();
+    bool keyframesOk = writeKeyframesFile();
+    bool hashesOk = writeStateHashesFile();
     
-    return stepsOk && resultOk;
+    return stepsOk && resultOk && keyframesOk && hashesOk;
 }
 
 // Playback methods
@@ -182,9 +210,8 @@ bool GameRecorder::hasNextEvent() const {
 }
 
 const GameEvent& GameRecorder::peekNextEvent() const {
-    static GameEvent empty;
     if (currentEventIndex_ >= loadedEvents_.size()) {
-        return empty;
+        return emptyEvent_;
     }
     return loadedEvents_[currentEventIndex_];
 }
@@ -201,6 +228,36 @@ bool GameRecorder::shouldProcessEvent(int currentCycle) const {
     return loadedEvents_[currentEventIndex_].getCycle() <= currentCycle;
 }
 
+void GameRecorder::seekToEvent(size_t index) {
+    currentEventIndex_ = (std::min)(index, loadedEvents_.size());
+}
+
+void GameRecorder::discardExpectedResultsBefore(int cycle) {
+    expectedResults_.erase(
+        std::remove_if(expectedResults_.begin(), expectedResults_.end(),
+                       [cycle](const ResultEntry& r) { return r.getCycle() < cycle; }),
+        expectedResults_.end());
+}
+
+bool GameRecorder::hasStateHashesIn(int fromCycle, int toCycle) const {
+    auto it = std::lower_bound(expectedStateHashes_.begin(), expectedStateHashes_.end(), fromCycle,
+                               [](const std::pair<int, unsigned long long>& e, int c) { return e.first < c; });
+    return it != expectedStateHashes_.end() && it->first < toCycle;
+}
+
+void GameRecorder::checkStateHashes(int fromCycle, int toCycle, unsigned long long hash) {
+    auto it = std::lower_bound(expectedStateHashes_.begin(), expectedStateHashes_.end(), fromCycle,
+                               [](const std::pair<int, unsigned long long>& e, int c) { return e.first < c; });
+    for (; it != expectedStateHashes_.end() && it->first < toCycle; ++it) {
+        if (it->second != hash) {
+            if (firstStateHashMismatch_ < 0 || it->first < firstStateHashMismatch_) {
+                firstStateHashMismatch_ = it->first;
+            }
+            return;
+        }
+    }
+}
+
 void GameRecorder::addActualResult(int cycle, const std::string& description) {
     actualResults_.emplace_back(cycle, description);
 }
@@ -287,7 +344,33 @@ bool GameRecorder::verifyResults(std::string& errorMessage) const {
     return true;
 }
 
+int GameRecorder::findFirstMismatchCycle(int fromCycle, int toCycle) const {
+    auto inRange = [fromCycle, toCycle](const ResultEntry& r) {
+        return r.getCycle() >= fromCycle && r.getCycle() < toCycle;
+    };
+    std::vector<ResultEntry> expected, actual;
+    std::copy_if(expectedResults_.begin(), expectedResults_.end(), std::back_inserter(expected), inRange);
+    std::copy_if(actualResults_.begin(), actualResults_.end(), std::back_inserter(actual), inRange);
+
+    size_t common = (std::min)(actual.size(), expected.size());
+    for (size_t i = 0; i < common; ++i) {
+        const ResultEntry& exp = expected[i];
+        const ResultEntry& act = actual[i];
+        if (exp.getCycle() != act.getCycle() || exp.getDescription() != act.getDescription()) {
+            return (std::min)(exp.getCycle(), act.getCycle());
+        }
+    }
+    if (expected.size() > common) return expected[common].getCycle();
+    if (actual.size() > common) return actual[common].getCycle();
+    return -1;
+}
+
 // File I/O
+std::string GameRecorder::pathFor(const char* fileName) const {
+    if (directory_.empty()) return fileName;
+    return (std::filesystem::path(directory_) / fileName).string();
+}
+
 bool GameRecorder::writeStepsFile() {
     std::ofstream file(STEPS_FILE);
     if (!file.is_open()) {
@@ -341,10 +424,126 @@ bool GameRecorder::writeResultFile() {
     return true;
 }
 
+bool GameRecorder::writeKeyframesFile() {
+    std::ofstream file(KEYFRAMES_FILE);
+    if (!file.is_open()) {
+        FileParser::reportError("Cannot create keyframes file: " + std::string(KEYFRAMES_FILE));
+        return false;
+    }
+    
+    file << "# adv-world Keyframes File\n";
+    file << "# Full game state every " << KEYFRAME_INTERVAL << " cycles, taken before that cycle's input\n";
+    file << "\n";
+    
+    for (const auto& frame : recordedKeyframes_) {
+        frame.write(file);
+    }
+    
+    file.close();
+    return true;
+}
+
+bool GameRecorder::writeStateHashesFile() {
+    std::ofstream file(STATE_HASHES_FILE);
+    if (!file.is_open()) {
+        FileParser::reportError("Cannot create state hashes file: " + std::string(STATE_HASHES_FILE));
+        return false;
+    }
+    
+    file << "# adv-world State Hashes File\n";
+    file << "# Format: CYCLE HASH (world state before that cycle's input, every " << STATE_HASH_INTERVAL << " cycles)\n";
+    file << "\n";
+    
+    file << std::hex << std::setfill('0');
+    for (const auto& entry : recordedStateHashes_) {
+        file << std::dec << entry.first << " " << std::hex << std::setw(16) << entry.second << "\n";
+    }
+    
+    file.close();
+    return true;
+}
+
+void GameRecorder::readStateHashesFile() {
+    std::vector<std::string> lines = FileParser::readFileLines(pathFor(STATE_HASHES_FILE));
+    
+    for (const auto& rawLine : lines) {
+        std::string line = FileParser::trim(rawLine);
+        if (line.empty() || line[0] == '#') continue;
+        
+        // One line per cycle, so this avoids a stream per line
+        const char* end = line.data() + line.size();
+        int cycle = -1;
+        unsigned long long hash = 0;
+        auto parsedCycle = std::from_chars(line.data(), end, cycle);
+        const char* hashStart = parsedCycle.ptr;
+        while (hashStart < end && *hashStart == ' ') ++hashStart;
+        auto parsedHash = std::from_chars(hashStart, end, hash, 16);
+        if (parsedCycle.ec != std::errc() || parsedHash.ec != std::errc() || hashStart == parsedCycle.ptr || cycle < 0 ||
+            (!expectedStateHashes_.empty() && cycle <= expectedStateHashes_.back().first)) {
+            FileParser::reportError("Ignoring malformed state hash line: " + line);
+            continue;
+        }
+        expectedStateHashes_.emplace_back(cycle, hash);
+    }
+}
+
+std::vector<Keyframe> GameRecorder::loadKeyframes() const {
+    // Keyframes are optional: recordings made before they existed have no keyframes file
+    std::vector<std::string> lines = FileParser::readFileLines(pathFor(KEYFRAMES_FILE));
+    
+    std::vector<Keyframe> frames;
+    bool inFrame = false;
+    bool frameValid = false;
+    Keyframe current;
+    
+    for (const auto& rawLine : lines) {
+        std::string line = FileParser::trim(rawLine);
+        if (line.empty() || line[0] == '#') continue;
+        
+        std::istringstream iss(line);
+        std::string keyword;
+        iss >> keyword;
+        
+        if (keyword == "KEYFRAME") {
+            int cycle = -1;
+            size_t stepIndex = 0;
+            iss >> cycle >> stepIndex;
+            current = Keyframe();
+            current.setCycle(cycle);
+            current.setStepIndex(stepIndex);
+            inFrame = true;
+            frameValid = (cycle >= 0) && (frames.empty() || cycle > frames.back().getCycle());
+        }
+        else if (keyword == "END") {
+            if (inFrame && frameValid) {
+                frames.push_back(current);
+            } else if (inFrame) {
+                FileParser::reportError("Skipping malformed keyframe at cycle " + std::to_string(current.getCycle()));
+            }
+            inFrame = false;
+        }
+        else if (inFrame && !current.parseLine(line)) {
+            frameValid = false;
+        }
+    }
+    
+    return frames;
+}
+
+bool GameRecorder::loadKeyframe(int maxCycle, Keyframe& frame) const {
+    bool found = false;
+    for (const auto& k : loadKeyframes()) {
+        if (k.getCycle() > maxCycle) break;
+        frame = k;
+        found = true;
+    }
+    return found;
+}
+
 bool GameRecorder::readStepsFile() {
-    std::vector<std::string> lines = FileParser::readFileLines(STEPS_FILE);
+    std::vector<std::string> lines = FileParser::readFileLines(pathFor(STEPS_FILE));
     if (lines.empty()) {
-        FileParser::reportError("Cannot read steps file or file is empty: " + std::string(STEPS_FILE));
+        FileParser::reportError("Cannot read steps file or file is empty: " + pathFor(STEPS_FILE));
         return false;
     }
     
@@ -387,7 +586,7 @@ bool GameRecorder::readStepsFile() {
 }
 
 bool GameRecorder::readResultFile() {
-    std::vector<std::string> lines = FileParser::readFileLines(RESULT_FILE);
+    std::vector<std::string> lines = FileParser::readFileLines(pathFor(RESULT_FILE));
     if (lines.empty()) {
         // Result file is optional - return true but with empty results
         return true;
@@ -2,7 +2,10 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <climits>
+#include <utility>
 #include "Point.h"
+#include "Keyframe.h"
 
 // Enum for game run modes
 enum class GameMode {
@@ -87,13 +90,21 @@ public:
     // File names
     static constexpr const char* STEPS_FILE = "adv-world.steps";
     static constexpr const char* RESULT_FILE = "adv-world.result";
+    static constexpr const char* KEYFRAMES_FILE = "adv-world.keyframes";
+    static constexpr const char* STATE_HASHES_FILE = "adv-world.hashes";
+    
+    // Save mode writes a full-state keyframe every this many cycles
+    static constexpr int KEYFRAME_INTERVAL = 500;
+    
+    // ... and a world-state hash every this many cycles (1 = the exact cycle a replay diverges)
+    static constexpr int STATE_HASH_INTERVAL = 1;
     
     GameRecorder();
     ~GameRecorder();
     
     // Initialize for save or load mode
     bool initForSave(const std::vector<std::string>& screenFiles);
-    bool initForLoad();
+    bool initForLoad(const std::string& directory = "");  // Empty directory = current working directory
     
     // Recording methods (save mode)
     void recordKeyPress(int cycle, int playerIndex, char key);
@@ -102,6 +113,11 @@ public:
     void recordRiddleEncounter(int cycle, int playerIndex, const std::string& question);
     void recordRiddleAnswer(int cycle, int playerIndex, const std::string& answer, bool correct);
     void recordGameEnd(int cycle, int score, bool isWin);
+    void recordKeyframe(const Keyframe& frame);
+    void recordStateHash(int cycle, unsigned long long hash);
+    
+    // Number of lines written to the steps file so far (= playback event index)
+    size_t getRecordedStepCount() const { return recordedStepCount_; }
     
     // Finalize and write files (save mode)
     bool finalizeRecording();
@@ -111,16 +127,34 @@ public:
     const GameEvent& peekNextEvent() const;
     GameEvent consumeNextEvent();
     bool shouldProcessEvent(int currentCycle) const;
+    size_t getEventIndex() const { return currentEventIndex_; }
+    int getLastEventCycle() const { return loadedEvents_.empty() ? 0 : loadedEvents_.back().getCycle(); }
+    
+    // Seeking (load mode): the latest keyframe at or before maxCycle, if the recording has one
+    bool loadKeyframe(int maxCycle, Keyframe& frame) const;
+    std::vector<Keyframe> loadKeyframes() const;  // All keyframes in cycle order (empty if none)
+    void seekToEvent(size_t index);
+    void discardExpectedResultsBefore(int cycle);  // Verify only what happens after a seek
+    
+    // State hashes (load mode). Hashes are checked by cycle, so seeking needs no bookkeeping.
+    bool hasStateHashesIn(int fromCycle, int toCycle) const;  // Any recorded hash with fromCycle <= cycle < toCycle
+    void checkStateHashes(int fromCycle, int toCycle, unsigned long long hash);  // Same state for all of them
+    int getFirstStateHashMismatchCycle() const { return firstStateHashMismatch_; }  // -1 if none differed
     
     // Get expected results for verification (load mode)
     const std::vector<ResultEntry>& getExpectedResults() const { return expectedResults_; }
     
     // Add actual result for comparison (load mode)
     void addActualResult(int cycle, const std::string& description);
+    size_t getActualResultCount() const { return actualResults_.size(); }
     
     // Compare actual vs expected results (load silent mode)
     bool verifyResults(std::string& errorMessage) const;
     
+    // Cycle of the first actual result that differs from the expected one (-1 if all match).
+    // Only results with fromCycle <= cycle < toCycle take part (used per segment).
+    int findFirstMismatchCycle(int fromCycle = 0, int toCycle = INT_MAX) const;
+    
     // Get screen files that were recorded with
     const std::vector<std::string>& getScreenFiles() const { return screenFiles_; }
     
@@ -131,18 +165,29 @@ std::vector<std::string> screenFiles_;
 // For recording
     std::vector<GameEvent> recordedEvents_;
     std::vector<ResultEntry> recordedResults_;
+    std::vector<Keyframe> recordedKeyframes_;
+    std::vector<std::pair<int, unsigned long long>> recordedStateHashes_;
+    size_t recordedStepCount_ = 0;
     
     // For playback
+    std::string directory_;
     std::vector<GameEvent> loadedEvents_;
+    GameEvent emptyEvent_;  // Returned by peekNextEvent when no events are left
     size_t currentEventIndex_;
     std::vector<ResultEntry> expectedResults_;
     std::vector<ResultEntry> actualResults_;
+    std::vector<std::pair<int, unsigned long long>> expectedStateHashes_;  // Sorted by cycle
+    int firstStateHashMismatch_ = -1;
     
     // File I/O helpers
+    std::string pathFor(const char* fileName) const;
     bool writeStepsFile();
     bool writeResultFile();
+    bool writeKeyframesFile();
+    bool writeStateHashesFile();
     bool readStepsFile();
     bool readResultFile();
+    void readStateHashesFile();
     
     // Parsing helpers
     static std::string eventTypeToString(GameEventType type);
@@ -1,5 +1,6 @@
 #include "GameState.h"
 #include "FileParser.h"
+#include "Platform.h"
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -85,13 +86,13 @@ std::string GameState::buildSavePath(const std::string& saveName) {
 }
 
 std::string GameState::formatTimestamp(std::time_t timestamp) {
-    std::tm tm_buf; localtime_s(&tm_buf, &timestamp);
+    std::tm tm_buf; Platform::localTime(timestamp, tm_buf);
     std::ostringstream oss; oss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S"); return oss.str();
 }
 
 std::string GameState::generateDefaultSaveName() {
     std::time_t now = std::time(nullptr);
-    std::tm tm_buf; localtime_s(&tm_buf, &now);
+    std::tm tm_buf; Platform::localTime(now, tm_buf);
     std::ostringstream oss; oss << "save_" << std::put_time(&tm_buf, "%Y%m%d_%H%M%S"); return oss.str();
 }
 
@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include <array>
+#include <cstddef>
 
 // Glyph class - contains game character constants and classification methods
 class Glyph {
@@ -45,28 +47,103 @@ public:
     // Special door glyph
     static inline constexpr wchar_t SpecialDoor = L'\x25A0';
 
-    // Classification methods
-    static bool isDoor(wchar_t ch) { return ch >= L'A' && ch <= L'Z'; }
-    static bool isKey(wchar_t ch) { return ch >= L'a' && ch <= L'z'; }
-    static bool isRiddle(wchar_t ch) { return ch == Riddle || ch == L'\xFF1F'; }
-    static bool isBomb(wchar_t ch) { return ch == Bomb; }
-    static bool isTorch(wchar_t ch) { return ch == Torch; }
-    static bool isBombableWall(wchar_t ch) { return ch == Bombable_Wall_Caret; }
-    static bool isSpring(wchar_t ch) { return ch == Spring; }
-    static bool isObstacle(wchar_t ch) { return ch == Obstacle; }
-    static bool isSwitch(wchar_t ch) { return ch == Switch_Off || ch == Switch_On; }
-    static bool isPressureButton(wchar_t ch) { return ch == PressureSwitch; }
-    static bool isSpecialDoor(wchar_t ch) { return ch == SpecialDoor; }
-    static bool isDarkness(wchar_t ch) { 
-        return ch == Dark_Light || ch == Dark_Medium || ch == Dark_Heavy || ch == Dark_Full; 
+    // Classification flags, one bit per kind of cell. The masks combine them.
+    struct Tile {
+        enum : unsigned short {
+            Wall           = 1 << 0,
+            Bombable       = 1 << 1,
+            Door           = 1 << 2,
+            Key            = 1 << 3,
+            Riddle         = 1 << 4,
+            Bomb           = 1 << 5,
+            Torch          = 1 << 6,
+            Spring         = 1 << 7,
+            Obstacle       = 1 << 8,
+            Switch         = 1 << 9,
+            PressureButton = 1 << 10,
+            SpecialDoor    = 1 << 11,
+            Darkness       = 1 << 12,
+
+            Collectible    = Key | Bomb | Torch,  // Picked up by walking onto it
+            Blocking       = Wall | Door          // Stops pushed obstacles and flying players
+        };
+    };
+
+    // Flags of a cell code: a single table load (ASCII, the U+2500..U+25FF box/block range and U+FF1F)
+    static constexpr unsigned short flags(wchar_t ch);
+
+    // True if the cell has any of the flags in mask
+    static constexpr bool is(wchar_t ch, unsigned short mask) { return (flags(ch) & mask) != 0; }
+
+    // Classification methods. Comparisons and range checks stay that way where they beat the
+    // table in the glyphs benchmark (they vectorize in scans over a whole screen); the long chains
+    // (walls, riddles, switches) are one table load and mask.
+    static constexpr bool isBomb(wchar_t ch) { return ch == Bomb; }
+    static constexpr bool isTorch(wchar_t ch) { return ch == Torch; }
+    static constexpr bool isBombableWall(wchar_t ch) { return ch == Bombable_Wall_Caret; }
+    static constexpr bool isSpring(wchar_t ch) { return ch == Spring; }
+    static constexpr bool isObstacle(wchar_t ch) { return ch == Obstacle; }
+    static constexpr bool isPressureButton(wchar_t ch) { return ch == PressureSwitch; }
+    static constexpr bool isSpecialDoor(wchar_t ch) { return ch == SpecialDoor; }
+    static constexpr bool isDoor(wchar_t ch) { return ch >= L'A' && ch <= L'Z'; }
+    static constexpr bool isKey(wchar_t ch) { return ch >= L'a' && ch <= L'z'; }
+    static constexpr bool isRiddle(wchar_t ch) { return is(ch, Tile::Riddle); }
+    static constexpr bool isSwitch(wchar_t ch) { return is(ch, Tile::Switch); }
+    static constexpr bool isDarkness(wchar_t ch) {
+        return ch == Dark_Light || ch == Dark_Medium || ch == Dark_Heavy || ch == Dark_Full;
+    }
+    static constexpr bool isWall(wchar_t ch) { return is(ch, Tile::Wall); }
+    static constexpr bool isCollectible(wchar_t ch) { return isKey(ch) || isBomb(ch) || isTorch(ch); }
+
+private:
+    static constexpr unsigned BoxRangeFirst = 0x2500;
+    static constexpr unsigned FullWidthQuestion = 0xFF1F;  // Riddles may use either question mark
+    static constexpr size_t AsciiCount = 128;
+    static constexpr size_t FullWidthQuestionSlot = AsciiCount + 256;
+    static constexpr size_t FlagTableSize = FullWidthQuestionSlot + 1;
+
+    // Slot of a cell code in FlagTable. Codes without a slot share NUL's (no flags).
+    // Written without branches so classifying a row of cells vectorizes.
+    static constexpr size_t tableIndex(unsigned c) {
+        size_t box = c - BoxRangeFirst;
+        size_t index = c < AsciiCount ? c : 0;
+        index = box < 256 ? AsciiCount + box : index;
+        index = c == FullWidthQuestion ? FullWidthQuestionSlot : index;
+        return index;
     }
 
-    static bool isWall(wchar_t ch) {
-        if (ch == Wall_Single_TL || ch == Wall_Single_TR || ch == Wall_Single_BL || ch == Wall_Single_BR ||
-            ch == Wall_Single_H || ch == Wall_Single_V || ch == Wall_Single_TRgt || ch == Wall_Single_TLft ||
-            ch == Wall_Single_TDown || ch == Wall_Single_TUp || ch == Wall_Single_Cross ||
-            ch == Bombable_Wall_H || ch == Bombable_Wall_V)
-            return true;
-        return false;
+    static constexpr std::array<unsigned short, FlagTableSize> buildFlagTable() {
+        std::array<unsigned short, FlagTableSize> t{};
+        auto set = [&t](wchar_t ch, unsigned short f) { t[tableIndex((unsigned)ch)] |= f; };
+
+        for (wchar_t ch : { Wall_Single_TL, Wall_Single_TR, Wall_Single_BL, Wall_Single_BR,
+                            Wall_Single_H, Wall_Single_V, Wall_Single_TRgt, Wall_Single_TLft,
+                            Wall_Single_TDown, Wall_Single_TUp, Wall_Single_Cross,
+                            Bombable_Wall_H, Bombable_Wall_V })
+            set(ch, Tile::Wall);
+        for (wchar_t ch = L'A'; ch <= L'Z'; ++ch) set(ch, Tile::Door);
+        for (wchar_t ch = L'a'; ch <= L'z'; ++ch) set(ch, Tile::Key);
+        for (wchar_t ch : { Dark_Light, Dark_Medium, Dark_Heavy, Dark_Full }) set(ch, Tile::Darkness);
+
+        set(Bombable_Wall_Caret, Tile::Bombable);
+        set(Riddle, Tile::Riddle);
+        set((wchar_t)FullWidthQuestion, Tile::Riddle);
+        set(Bomb, Tile::Bomb);
+        set(Torch, Tile::Torch);
+        set(Spring, Tile::Spring);
+        set(Obstacle, Tile::Obstacle);
+        set(Switch_Off, Tile::Switch);
+        set(Switch_On, Tile::Switch);
+        set(PressureSwitch, Tile::PressureButton);
+        set(SpecialDoor, Tile::SpecialDoor);
+        return t;
     }
+
+    static const std::array<unsigned short, FlagTableSize> FlagTable;
 };
+
+inline constexpr std::array<unsigned short, Glyph::FlagTableSize> Glyph::FlagTable = Glyph::buildFlagTable();
+
+constexpr unsigned short Glyph::flags(wchar_t ch) {
+    return FlagTable[tableIndex((unsigned)ch)];
+}
@@ -0,0 +1,193 @@
+#include "Keyframe.h"
+#include <sstream>
+#include <algorithm>
+
+Keyframe::Keyframe()
+    : cycle_(0), stepIndex_(0), visibleRoomIdx_(0), heartsCount_(3), pointsCount_(0), finalRoomFocusTicks_(0) {}
+
+void Keyframe::write(std::ostream& out) const {
+    out << "KEYFRAME " << cycle_ << " " << stepIndex_ << "\n";
+    out << "STATE " << visibleRoomIdx_ << " " << heartsCount_ << " " << pointsCount_ << " " << finalRoomFocusTicks_ << "\n";
+
+    out << "FINAL_FLAGS " << playerReachedFinalRoom_.size();
+    for (bool flag : playerReachedFinalRoom_) {
+        out << " " << (flag ? 1 : 0);
+    }
+    out << "\n";
+
+    for (const auto& p : players_) {
+        out << "PLAYER " << p.roomIdx << " " << p.x << " " << p.y << " " << p.diffX << " " << p.diffY << " "
+            << (int)p.carried << " " << (p.actionRequested ? 1 : 0) << " "
+            << p.springRoomIdx << " " << p.springIdx << " " << p.entryIndex << " " << p.compressedCount << " "
+            << p.boostTicksLeft << " " << p.boostSpeed << " " << p.boostDirX << " " << p.boostDirY << "\n";
+    }
+
+    // One line per room: MODS <room> <count> then x y char triples
+    for (const auto& kv : screenModifications_) {
+        out << "MODS " << kv.first << " " << kv.second.size();
+        for (const auto& tup : kv.second) {
+            out << " " << std::get<0>(tup) << " " << std::get<1>(tup) << " " << (int)std::get<2>(tup);
+        }
+        out << "\n";
+    }
+
+    // Cells sorted (room, row, column): the order an obstacle was scanned in is not part of the state
+    for (const auto& o : obstacles_) {
+        std::vector<ObCell> cells = o.cells;
+        std::sort(cells.begin(), cells.end(), [](const ObCell& a, const ObCell& b) {
+            if (a.getRoomIdx() != b.getRoomIdx()) return a.getRoomIdx() < b.getRoomIdx();
+            if (a.getPos().getY() != b.getPos().getY()) return a.getPos().getY() < b.getPos().getY();
+            return a.getPos().getX() < b.getPos().getX();
+        });
+        out << "OBSTACLE " << o.roomIdx << " " << cells.size();
+        for (const auto& c : cells) {
+            out << " " << c.getRoomIdx() << " " << c.getPos().getX() << " " << c.getPos().getY();
+        }
+        out << "\n";
+    }
+
+    for (const auto& b : bombs_) {
+        out << "BOMB " << b.roomIdx << " " << b.x << " " << b.y << " " << b.ticksLeft << "\n";
+    }
+
+    for (const auto& s : switches_) {
+        out << "SWITCH " << s.roomIdx << " " << s.switchIdx << " " << (s.on ? 1 : 0) << "\n";
+    }
+
+    for (const auto& d : doors_) {
+        out << "DOOR " << d.roomIdx << " " << d.doorIdx << " " << (d.open ? 1 : 0) << " " << d.keysInserted.size();
+        for (char k : d.keysInserted) {
+            out << " " << (int)k;
+        }
+        out << "\n";
+    }
+
+    for (const auto& r : riddles_) {
+        out << "RIDDLE " << r.roomIdx << " " << r.x << " " << r.y << " " << r.points << "\n";
+    }
+
+    out << "END\n";
+}
+
+bool Keyframe::read(const std::string& text) {
+    *this = Keyframe();
+    std::istringstream in(text);
+    std::string line;
+    bool started = false;
+
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        if (!started) {
+            std::istringstream iss(line);
+            std::string keyword;
+            iss >> keyword >> cycle_ >> stepIndex_;
+            if (keyword != "KEYFRAME" || iss.fail()) return false;
+            started = true;
+        }
+        else if (line == "END") {
+            return true;
+        }
+        else if (!parseLine(line)) {
+            return false;
+        }
+    }
+    return false;  // No END line
+}
+
+unsigned long long Keyframe::hash() const {
+    std::ostringstream oss;
+    write(oss);
+    unsigned long long h = 14695981039346656037ULL;
+    for (unsigned char c : oss.str()) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool Keyframe::parseLine(const std::string& line) {
+    std::istringstream iss(line);
+    std::string keyword;
+    iss >> keyword;
+
+    if (keyword == "STATE") {
+        iss >> visibleRoomIdx_ >> heartsCount_ >> pointsCount_ >> finalRoomFocusTicks_;
+    }
+    else if (keyword == "FINAL_FLAGS") {
+        int count = 0;
+        iss >> count;
+        playerReachedFinalRoom_.clear();
+        for (int i = 0; i < count && iss; ++i) {
+            int flag = 0;
+            iss >> flag;
+            playerReachedFinalRoom_.push_back(flag != 0);
+        }
+    }
+    else if (keyword == "PLAYER") {
+        PlayerEntry p;
+        int carried = ' ', action = 0;
+        iss >> p.roomIdx >> p.x >> p.y >> p.diffX >> p.diffY >> carried >> action
+            >> p.springRoomIdx >> p.springIdx >> p.entryIndex >> p.compressedCount
+            >> p.boostTicksLeft >> p.boostSpeed >> p.boostDirX >> p.boostDirY;
+        p.carried = (char)carried;
+        p.actionRequested = (action != 0);
+        players_.push_back(p);
+    }
+    else if (keyword == "MODS") {
+        int roomIdx = 0, count = 0;
+        iss >> roomIdx >> count;
+        auto& mods = screenModifications_[roomIdx];
+        for (int i = 0; i < count && iss; ++i) {
+            int x = 0, y = 0, ch = 0;
+            iss >> x >> y >> ch;
+            mods.push_back(std::make_tuple(x, y, (wchar_t)ch));
+        }
+    }
+    else if (keyword == "OBSTACLE") {
+        ObstacleEntry o;
+        int count = 0;
+        iss >> o.roomIdx >> count;
+        for (int i = 0; i < count && iss; ++i) {
+            int room = 0, x = 0, y = 0;
+            iss >> room >> x >> y;
+            o.cells.push_back(ObCell(room, Point(x, y)));
+        }
+        obstacles_.push_back(o);
+    }
+    else if (keyword == "BOMB") {
+        BombEntry b;
+        iss >> b.roomIdx >> b.x >> b.y >> b.ticksLeft;
+        bombs_.push_back(b);
+    }
+    else if (keyword == "SWITCH") {
+        SwitchEntry s;
+        int on = 0;
+        iss >> s.roomIdx >> s.switchIdx >> on;
+        s.on = (on != 0);
+        switches_.push_back(s);
+    }
+    else if (keyword == "DOOR") {
+        DoorEntry d;
+        int open = 0, count = 0;
+        iss >> d.roomIdx >> d.doorIdx >> open >> count;
+        d.open = (open != 0);
+        for (int i = 0; i < count && iss; ++i) {
+            int k = 0;
+            iss >> k;
+            d.keysInserted.push_back((char)k);
+        }
+        doors_.push_back(d);
+    }
+    else if (keyword == "RIDDLE") {
+        RiddleEntry r;
+        iss >> r.roomIdx >> r.x >> r.y >> r.points;
+        riddles_.push_back(r);
+    }
+    else {
+        return false;
+    }
+
+    return !iss.fail();
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <ostream>
+#include "Obstacle.h"
+
+// Complete simulation state at the start of one game cycle.
+// Save mode writes one every KEYFRAME_INTERVAL cycles into the recording, so playback
+// can restore the nearest one and simulate only the remaining cycles (-seek).
+// Unlike GameStateData it also covers the state a save file does not need:
+// bombs, spring/boost state, switches, special door keys and the obstacle layout.
+class Keyframe {
+public:
+    struct PlayerEntry {
+        int roomIdx = 0;
+        int x = 0;
+        int y = 0;
+        int diffX = 0;
+        int diffY = 0;
+        char carried = ' ';
+        bool actionRequested = false;
+        int springRoomIdx = -1;   // Spring the player stands on (room + index in its springs list)
+        int springIdx = -1;
+        int entryIndex = -1;
+        int compressedCount = 0;
+        int boostTicksLeft = 0;
+        int boostSpeed = 0;
+        int boostDirX = 0;
+        int boostDirY = 0;
+    };
+
+    struct BombEntry {
+        int roomIdx = 0;
+        int x = 0;
+        int y = 0;
+        int ticksLeft = 0;
+    };
+
+    struct SwitchEntry {
+        int roomIdx = 0;
+        int switchIdx = 0;
+        bool on = false;
+    };
+
+    struct DoorEntry {
+        int roomIdx = 0;
+        int doorIdx = 0;
+        bool open = false;
+        std::string keysInserted;
+    };
+
+    struct RiddleEntry {
+        int roomIdx = 0;
+        int x = 0;
+        int y = 0;
+        int points = 0;
+    };
+
+    // Obstacles are stored per room (an obstacle crossing rooms is listed in each of them)
+    struct ObstacleEntry {
+        int roomIdx = 0;
+        std::vector<ObCell> cells;
+    };
+
+    Keyframe();
+
+    // Cycle this keyframe was taken at (before that cycle's input) and how many
+    // steps of the recording had been consumed by then
+    void setCycle(int c) { cycle_ = c; }
+    int getCycle() const { return cycle_; }
+    void setStepIndex(size_t idx) { stepIndex_ = idx; }
+    size_t getStepIndex() const { return stepIndex_; }
+
+    void setVisibleRoomIdx(int idx) { visibleRoomIdx_ = idx; }
+    int getVisibleRoomIdx() const { return visibleRoomIdx_; }
+    void setHeartsCount(int h) { heartsCount_ = h; }
+    int getHeartsCount() const { return heartsCount_; }
+    void setPointsCount(int p) { pointsCount_ = p; }
+    int getPointsCount() const { return pointsCount_; }
+    void setFinalRoomFocusTicks(int t) { finalRoomFocusTicks_ = t; }
+    int getFinalRoomFocusTicks() const { return finalRoomFocusTicks_; }
+
+    void setPlayerReachedFinalRoom(const std::vector<bool>& flags) { playerReachedFinalRoom_ = flags; }
+    const std::vector<bool>& getPlayerReachedFinalRoom() const { return playerReachedFinalRoom_; }
+
+    const std::vector<PlayerEntry>& getPlayers() const { return players_; }
+    std::vector<PlayerEntry>& getPlayersMutable() { return players_; }
+
+    // Cells that differ from the screen files, per room
+    const std::map<int, std::vector<std::tuple<int, int, wchar_t>>>& getScreenModifications() const { return screenModifications_; }
+    std::map<int, std::vector<std::tuple<int, int, wchar_t>>>& getScreenModificationsMutable() { return screenModifications_; }
+
+    const std::vector<BombEntry>& getBombs() const { return bombs_; }
+    std::vector<BombEntry>& getBombsMutable() { return bombs_; }
+    const std::vector<SwitchEntry>& getSwitches() const { return switches_; }
+    std::vector<SwitchEntry>& getSwitchesMutable() { return switches_; }
+    const std::vector<DoorEntry>& getDoors() const { return doors_; }
+    std::vector<DoorEntry>& getDoorsMutable() { return doors_; }
+    const std::vector<RiddleEntry>& getRiddles() const { return riddles_; }
+    std::vector<RiddleEntry>& getRiddlesMutable() { return riddles_; }
+    const std::vector<ObstacleEntry>& getObstacles() const { return obstacles_; }
+    std::vector<ObstacleEntry>& getObstaclesMutable() { return obstacles_; }
+
+    // Text form: a "KEYFRAME <cycle> <steps>" line, one line per entry, then "END"
+    void write(std::ostream& out) const;
+
+    // Parse one line of the body (everything after the KEYFRAME line). Returns false if malformed.
+    bool parseLine(const std::string& line);
+
+    // Parse one complete keyframe (KEYFRAME line to END, as write() produces it). Returns false if malformed.
+    bool read(const std::string& text);
+
+    // FNV-1a hash of the text form: two runs reached the same state iff their keyframes hash equal
+    unsigned long long hash() const;
+
+private:
+    int cycle_;
+    size_t stepIndex_;
+    int visibleRoomIdx_;
+    int heartsCount_;
+    int pointsCount_;
+    int finalRoomFocusTicks_;
+    std::vector<bool> playerReachedFinalRoom_;
+
+    std::vector<PlayerEntry> players_;
+    std::map<int, std::vector<std::tuple<int, int, wchar_t>>> screenModifications_;
+    std::vector<BombEntry> bombs_;
+    std::vector<SwitchEntry> switches_;
+    std::vector<DoorEntry> doors_;
+    std::vector<RiddleEntry> riddles_;
+    std::vector<ObstacleEntry> obstacles_;
+};
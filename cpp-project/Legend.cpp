@@ -2,7 +2,6 @@
 #include "ScreenBuffer.h"
 #include <string>
 #include <vector>
-#include <windows.h>
 #include "Screen.h"
 #include "Point.h"
 
@@ -42,17 +41,17 @@ void Legend::locateLegendForRoom(int roomIdx, const Screen& s) {
 
 
 // Explicitly draw the anchor 'L' on screen for the given room
-void Legend::drawAnchor(int roomIdx) const {
+void Legend::drawAnchor(ScreenBuffer& buffer, int roomIdx) const {
     if (roomIdx < 0 || roomIdx >= (int)roomLegendPos.size()) 
         return;
     Point tl = roomLegendPos[roomIdx]; 
     if (tl.getX() == INVALID_LEGEND_POSITION || tl.getY() == INVALID_LEGEND_POSITION) 
         return;
-    tl.draw(LEGEND_ANCHOR_CHAR);
+    tl.draw(buffer, LEGEND_ANCHOR_CHAR);
 }
 
 // Written by AI
-void Legend::drawLegend(int roomIdx, int lives, int points, char p1Inv, char p2Inv) {
+void Legend::drawLegend(ScreenBuffer& buffer, int roomIdx, int lives, int points, char p1Inv, char p2Inv) {
 
     ensureRooms(static_cast<size_t>(roomIdx + 1));
     Point tl = roomLegendPos[roomIdx];
@@ -90,13 +89,12 @@ void Legend::drawLegend(int roomIdx, int lives, int points, char p1Inv, char p2I
         for (int i = 0; i < LEGEND_LINE_WIDTH; ++i) {
             Point p(origin.getX() + i, origin.getY() + dy);
             if (p.getX() >= 0 && p.getX() < Screen::MAX_X && p.getY() >= 0 && p.getY() < Screen::MAX_Y) {
-                p.draw(line[i]);
+                p.draw(buffer, line[i]);
             }
         }
     };
 
     auto putWideLine = [&](int dy, const wchar_t* wline) {
-        ScreenBuffer& buffer = ScreenBuffer::getInstance();
         int len = (int)wcslen(wline);
         if (len > LEGEND_LINE_WIDTH) len = LEGEND_LINE_WIDTH;
         for (int i = 0; i < len; ++i) {
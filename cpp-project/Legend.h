@@ -9,7 +9,7 @@ public:
     Legend() = default;
     void ensureRooms(size_t count);
     void locateLegendForRoom(int roomIdx, const Screen& s);
-    void drawAnchor(int roomIdx) const;
-    void drawLegend(int roomIdx, int lives, int points, char p1Inv, char p2Inv);
+    void drawAnchor(ScreenBuffer& buffer, int roomIdx) const;
+    void drawLegend(ScreenBuffer& buffer, int roomIdx, int lives, int points, char p1Inv, char p2Inv);
     static void scanAllLegends(std::vector<Screen>& world, Legend& legend);
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Lightmap.h"
+#include "DarkRoom.h"
+#include "Screen.h"
+#include "Player.h"
+#include <algorithm>
+
+static bool samePoint(const Point& a, const Point& b) {
+    return a.getX() == b.getX() && a.getY() == b.getY();
+}
+
+// Held light reaches 9 cells vertically; horizontal distance is scaled by 3/4, so 13 cells sideways
+CellMask Lightmap::heldReach(const Point& p) {
+    const int reachX = (DarkRoomManager::HEAVY_SHADE_RADIUS * 4) / 3 + 1;
+    const int reachY = DarkRoomManager::HEAVY_SHADE_RADIUS;
+    return CellMask::rect(p.getX() - reachX, p.getY() - reachY, p.getX() + reachX, p.getY() + reachY);
+}
+
+CellMask Lightmap::lyingReach(const Point& p) {
+    const int r = DarkRoomManager::DROPPED_TORCH_RADIUS;
+    return CellMask::rect(p.getX() - r, p.getY() - r, p.getX() + r, p.getY() + r);
+}
+
+void Lightmap::sync(const Screen& screen, const std::vector<Player>& players, int roomIdx) {
+    std::vector<Point>& held = heldNow_;
+    held.clear();
+    for (const auto& player : players) {
+        if (player.getRoomIdx() == roomIdx && player.getCarried() == '!') {
+            held.push_back(player.getPosition());
+        }
+    }
+    const CellMask& torches = screen.getTorchMask();
+
+    bool heldChanged = held.size() != held_.size() ||
+                       !std::equal(held.begin(), held.end(), held_.begin(), samePoint);
+    bool torchesChanged = torches != torches_;
+    if (built_ && !heldChanged && !torchesChanged) return;
+
+    // Cells whose level may change
+    CellMask dirty;
+    if (!built_) {
+        dirty = ~CellMask();
+    } else {
+        if (heldChanged) {
+            auto isIn = [](const std::vector<Point>& list, const Point& p) {
+                return std::any_of(list.begin(), list.end(), [&p](const Point& q) { return samePoint(p, q); });
+            };
+            for (const Point& p : held_) {
+                if (!isIn(held, p)) dirty |= heldReach(p);
+            }
+            for (const Point& p : held) {
+                if (!isIn(held_, p)) dirty |= heldReach(p);
+            }
+        }
+        if (torchesChanged) {
+            (torches ^ torches_).forEach([&dirty](int x, int y) { dirty |= lyingReach(Point(x, y)); });
+        }
+    }
+
+    if (!built_ || torchesChanged) {
+        torchLit_.clear();
+        for (const Point& t : screen.getTorches()) {
+            torchLit_ |= lyingReach(t);
+        }
+    }
+    held_.swap(held);
+    torches_ = torches;
+    built_ = true;
+
+    (dirty & screen.getDarkMask()).forEach([this](int x, int y) {
+        int level = torchLit_.test(x, y) ? 0 : DarkRoomManager::FULL_DARK_LEVEL;
+        for (const Point& h : held_) {
+            level = (std::min)(level, DarkRoomManager::levelFromDistance(DarkRoomManager::calculateDistance(Point(x, y), h)));
+        }
+        level_[y * CellMask::WIDTH + x] = (uint8_t)level;
+    });
+}
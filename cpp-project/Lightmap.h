@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Point.h"
+#include "CellMask.h"
+
+class Screen;
+class Player;
+
+// Darkness level of every cell of a dark room (0 = full light .. 4 = full dark, see DarkRoomManager),
+// cached per screen. The light comes from torches held by players in the room and torches lying on
+// the screen; sync compares them with the ones the map was built for and recomputes only the cells
+// within reach of a source that appeared, moved or went away.
+class Lightmap {
+public:
+    // Bring the map up to date with the current light sources of roomIdx
+    void sync(const Screen& screen, const std::vector<Player>& players, int roomIdx);
+
+    // Only meaningful for cells inside the screen's dark zones
+    int levelAt(const Point& p) const { return level_[p.getY() * CellMask::WIDTH + p.getX()]; }
+
+private:
+    bool built_ = false;
+    std::vector<Point> held_;   // Positions of the torch-carrying players at the last sync
+    std::vector<Point> heldNow_; // Scratch for the current ones (kept to avoid allocating on every sync)
+    CellMask torches_;          // Torches lying on the screen at the last sync
+    CellMask torchLit_;         // Cells a lying torch lights fully
+    std::array<uint8_t, CellMask::CELLS> level_{};
+
+    // Cells a torch held at p can light (beyond them every cell is full dark)
+    static CellMask heldReach(const Point& p);
+    // Cells a lying torch at p lights (the 9x9 square around it)
+    static CellMask lyingReach(const Point& p);
+};
@@ -1,16 +1,17 @@
-﻿#include <conio.h>
-#include <windows.h>
-#include <string>
+﻿#include <string>
 #include <vector>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
 #include <sstream>
+#include <iomanip>
+#include <ctime>
 
 #include "Menu.h"
 #include "Screen.h"
 #include "ScreenBuffer.h"
 #include "utils.h"
+#include "Platform.h"
 #include "GameState.h"
 
 using std::vector;
@@ -27,7 +28,7 @@ namespace {
     constexpr char START_MENU_CONTINUE_KEY = '2';
     constexpr char START_MENU_INSTRUCTIONS_KEY = '8';
     constexpr char START_MENU_EXIT_KEY = '9';
-    constexpr DWORD MENU_POLL_DELAY_MS = 180;
+    constexpr int MENU_POLL_DELAY_MS = 180;
     constexpr int SAVE_NAME_MAX_LENGTH = 30;
     constexpr int ESC_KEY = 27;
     constexpr int ENTER_KEY = 13;
@@ -43,11 +44,7 @@ namespace {
 //  ||----------------||
 
 static fs::path getExeDir() {
-    wchar_t buffer[MAX_PATH];
-    DWORD len = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
-    if (len == 0) return fs::current_path();
-    fs::path exePath(buffer);
-    return exePath.parent_path();
+    return fs::path(Platform::getExeDirectory());
 }
 
 static std::ifstream tryOpenScreenFile(const std::string& baseName) {
@@ -68,8 +65,8 @@ static std::ifstream tryOpenScreenFile(const std::string& baseName) {
 }
 
 // Print Goodbye ASCII art at top left and leave console as-is
-static void printGoodbyeArt() {
-    cls();
+static void printGoodbyeArt(ScreenBuffer& buffer) {
+    cls(buffer);
     const wchar_t* lines[] = {
         L"               \x250C\x2500\x2500\x2500\x2500\x2500\x2500\x2500\x2500\x2500\x2500\x2510",
         L"               \x2502 Goodbye! \x2502",
@@ -80,12 +77,12 @@ static void printGoodbyeArt() {
         L"  ||    (__)               ",
         L"  ||w--||                  "
     };
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    for (int i = 0; i < (int)(sizeof(lines)/sizeof(lines[0])); ++i) {
-        COORD pos{0, (SHORT)i};
-        SetConsoleCursorPosition(hOut, pos);
-        DWORD written; WriteConsoleW(hOut, lines[i], (DWORD)wcslen(lines[i]), &written, nullptr);
+    const int lineCount = (int)(sizeof(lines)/sizeof(lines[0]));
+    for (int i = 0; i < lineCount; ++i) {
+        buffer.writeText(0, i, lines[i]);
     }
+    buffer.flush();
+    gotoxy(0, lineCount);  // The shell continues below the art
 }
 
 vector<string> Menu::loadScreen(const string& filename) {
@@ -139,25 +136,25 @@ const vector<string>& Menu::getPauseTemplate() {
 //  || Menu Actions (__)
 //  ||-------------||
 
-void Menu::drawStartMenu() {
+void Menu::drawStartMenu(ScreenBuffer& buffer) {
     vector<string> startScreen = loadScreen("Start.screen");
     if (startScreen.empty()) {
         std::cerr << "Error: Start.screen not found or empty. Place .screen files next to the EXE or project root." << std::endl;
         return;
     }
     Screen screen(startScreen);
-    cls();
-    screen.draw();
-    ScreenBuffer::getInstance().flush();
+    cls(buffer);
+    screen.draw(buffer);
+    buffer.flush();
 }
 
-MenuAction Menu::showStartMenu() {
+MenuAction Menu::showStartMenu(ScreenBuffer& buffer) {
 
-    drawStartMenu();
+    drawStartMenu(buffer);
     
     while (true) {
-        if (_kbhit()) {
-            char key = _getch();
+        if (Platform::keyPressed()) {
+            char key = Platform::readKey();
             switch (key) {
                 case START_MENU_NEW_GAME_KEY:
                     return MenuAction::NewGame;
@@ -167,15 +164,15 @@ MenuAction Menu::showStartMenu() {
                     return MenuAction::Instructions;
                 case START_MENU_EXIT_KEY:
                     // Exit: clear screen, print goodbye art, then exit program
-                    printGoodbyeArt();
+                    printGoodbyeArt(buffer);
                     return MenuAction::Exit;
             }
         }
-        Sleep(MENU_POLL_DELAY_MS);
+        Platform::sleepMs(MENU_POLL_DELAY_MS);
     }
 }
 
-void Menu::showInstructions() {
+void Menu::showInstructions(ScreenBuffer& buffer) {
 
 vector<string> instructionsScreen = loadScreen("Instructions.screen");
 
@@ -184,20 +181,20 @@ if (instructionsScreen.empty()) {
 }
     
     Screen screen(instructionsScreen);
-    cls();
-    screen.draw();
-    ScreenBuffer::getInstance().flush();
+    cls(buffer);
+    screen.draw(buffer);
+    buffer.flush();
     
     while (true) {
-        if (_kbhit()) {
-            (void)_getch();
+        if (Platform::keyPressed()) {
+            (void)Platform::readKey();
             return;
         }
-        Sleep(MENU_POLL_DELAY_MS);
+        Platform::sleepMs(MENU_POLL_DELAY_MS);
     }
 }
 
-void Menu::showLoseScreen() {
+void Menu::showLoseScreen(ScreenBuffer& buffer) {
 
     vector<string> loseScreen = loadScreen("Lose.screen");
 
@@ -207,24 +204,24 @@ void Menu::showLoseScreen() {
     }
 
     Screen screen(loseScreen);
-    cls();
-    screen.draw();
-    ScreenBuffer::getInstance().flush();
+    cls(buffer);
+    screen.draw(buffer);
+    buffer.flush();
     
     // Flush keyboard buffer to avoid consuming stale input
-    while (_kbhit()) { (void)_getch();
+    while (Platform::keyPressed()) { (void)Platform::readKey();
     }
     
     while (true) {
-        if (_kbhit()) {
-            (void)_getch();
+        if (Platform::keyPressed()) {
+            (void)Platform::readKey();
             return;
         }
-        Sleep(MENU_POLL_DELAY_MS);
+        Platform::sleepMs(MENU_POLL_DELAY_MS);
     }
 }
 
-void Menu::showWinScreen() {
+void Menu::showWinScreen(ScreenBuffer& buffer) {
 
     vector<string> winScreen = loadScreen("Win.screen");
 
@@ -234,26 +231,26 @@ void Menu::showWinScreen() {
     }
 
     Screen screen(winScreen);
-    cls();
-    screen.draw();
-    ScreenBuffer::getInstance().flush();
+    cls(buffer);
+    screen.draw(buffer);
+    buffer.flush();
     
     // Flush keyboard buffer to avoid consuming stale input
-    while (_kbhit()) { (void)_getch();
+    while (Platform::keyPressed()) { (void)Platform::readKey();
     }
     
     while (true) {
-        if (_kbhit()) {
-            (void)_getch();
+        if (Platform::keyPressed()) {
+            (void)Platform::readKey();
             return;
         }
-        Sleep(MENU_POLL_DELAY_MS);
+        Platform::sleepMs(MENU_POLL_DELAY_MS);
     }
 }
 
 // Show save dialog - allows user to enter save name
-bool Menu::showSaveDialog(std::string& saveName) {
-    cls();
+bool Menu::showSaveDialog(ScreenBuffer& buffer, std::string& saveName) {
+    cls(buffer);
     
     // Load save game screen
     vector<string> saveScreen = loadScreen("SaveGame.screen");
@@ -263,23 +260,19 @@ bool Menu::showSaveDialog(std::string& saveName) {
     }
     
     Screen screen(saveScreen);
-    screen.draw();
-    ScreenBuffer::getInstance().flush();
+    screen.draw(buffer);
+    buffer.flush();
     
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    
-    // Position cursor for input (center of screen, row 16)
+    // Input field (center of screen, row 16), drawn through the buffer as the name is typed
     int inputX = 25;  // Centered position
     int inputY = 16;  // Middle of the screen
-    COORD inputPos{(SHORT)inputX, (SHORT)inputY};
-    SetConsoleCursorPosition(hOut, inputPos);
     
     string input;
     bool done = false;
     
     while (!done) {
-        if (_kbhit()) {
-            int key = _getch();
+        if (Platform::keyPressed()) {
+            int key = Platform::readKey();
             
             if (key == ESC_KEY) {
                 return false;  // Cancelled
@@ -290,24 +283,20 @@ bool Menu::showSaveDialog(std::string& saveName) {
             else if (key == BACKSPACE_KEY) {
                 if (!input.empty()) {
                     input.pop_back();
-                    // Redraw input area (clear and rewrite)
-                    SetConsoleCursorPosition(hOut, inputPos);
-                    for (int i = 0; i < SAVE_NAME_MAX_LENGTH; ++i) {
-                        std::cout << ' ';
-                    }
-                    SetConsoleCursorPosition(hOut, inputPos);
-                    std::cout << input;
+                    buffer.setChar(inputX + (int)input.size(), inputY, L' ');
+                    buffer.flush();
                 }
             }
             else if (isprint(key) && input.size() < SAVE_NAME_MAX_LENGTH) {
                 // Only allow safe characters for filenames
                 if (isalnum(key) || key == '_' || key == '-' || key == ' ') {
+                    buffer.setChar(inputX + (int)input.size(), inputY, (wchar_t)key);
                     input += (char)key;
-                    std::cout << (char)key;
+                    buffer.flush();
                 }
             }
         }
-        Sleep(50);
+        Platform::sleepMs(50);
     }
     
     // Use default name (current date and time) if empty
@@ -316,7 +305,7 @@ bool Menu::showSaveDialog(std::string& saveName) {
         // Note: Using dots and dashes because / : ; are not allowed in Windows filenames
         std::time_t now = std::time(nullptr);
         std::tm tm_buf;
-        localtime_s(&tm_buf, &now);
+        Platform::localTime(now, tm_buf);
         std::ostringstream oss;
         oss << std::put_time(&tm_buf, "%d.%m.%Y_(%H-%M)");
         saveName = oss.str();
@@ -332,8 +321,8 @@ bool Menu::showSaveDialog(std::string& saveName) {
 }
 
 // Show load dialog - displays available saves and lets user select
-std::string Menu::showLoadDialog() {
-    cls();
+std::string Menu::showLoadDialog(ScreenBuffer& buffer) {
+    cls(buffer);
     
     // Load the load game screen
     vector<string> loadScreen = Menu::loadScreen("LoadGame.screen");
@@ -343,13 +332,11 @@ std::string Menu::showLoadDialog() {
     }
     
     Screen screen(loadScreen);
-    screen.draw();
-    ScreenBuffer::getInstance().flush();
+    screen.draw(buffer);
+    buffer.flush();
     
     auto saves = GameState::getAvailableSaves();
     
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    
     if (saves.empty()) {
         // Replace the "Select a save file..." text on row 9 with "No saved games found" message
         const std::string noSavesMsg = "No saved games found. Press any key to return.";
@@ -362,12 +349,11 @@ std::string Menu::showLoadDialog() {
         int rightPadding = totalPadding - leftPadding;
         std::string centeredMsg = "\xE2\x94\x82" + std::string(leftPadding, ' ') + noSavesMsg + std::string(rightPadding, ' ') + "\xE2\x94\x82";
         
-        COORD msgPos{0, (SHORT)msgRow};
-        SetConsoleCursorPosition(hOut, msgPos);
-        std::cout << centeredMsg;
+        buffer.writeText(0, msgRow, Platform::utf8ToWide(centeredMsg));
+        buffer.flush();
         
-        while (!_kbhit()) Sleep(100);
-        (void)_getch();
+        while (!Platform::keyPressed()) Platform::sleepMs(100);
+        (void)Platform::readKey();
         return "";
     }
     
@@ -391,9 +377,6 @@ std::string Menu::showLoadDialog() {
         int row = savePositions[i][0];
         int col = savePositions[i][1];
         
-        COORD pos{(SHORT)col, (SHORT)row};
-        SetConsoleCursorPosition(hOut, pos);
-        
         // Get display name (filename without path and extension)
         std::string displayName = saves[i].second;
         // Remove .sav extension if present
@@ -433,13 +416,14 @@ std::string Menu::showLoadDialog() {
             displayName = displayName.substr(0, 22) + "...";
         }
         
-        std::cout << displayName;
+        buffer.writeText(col, row, Platform::utf8ToWide(displayName));
     }
+    buffer.flush();
     
     // Wait for selection
     while (true) {
-        if (_kbhit()) {
-            int key = _getch();
+        if (Platform::keyPressed()) {
+            int key = Platform::readKey();
             
             if (key == ESC_KEY) {
                 return "";  // Cancelled
@@ -452,6 +436,6 @@ std::string Menu::showLoadDialog() {
                 }
             }
         }
-        Sleep(100);
+        Platform::sleepMs(100);
     }
 }
\ No newline at end of file
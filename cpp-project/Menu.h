@@ -2,6 +2,8 @@
 #include <vector>
 #include <string>
 
+class ScreenBuffer;
+
 enum class MenuAction {
     None,
     NewGame,
@@ -14,17 +16,17 @@ enum class MenuAction {
 class Menu {
 public:
     // Menu actions
-    static MenuAction showStartMenu();
-    static void showInstructions();
-    static void showLoseScreen();
-    static void showWinScreen();
+    static MenuAction showStartMenu(ScreenBuffer& buffer);
+    static void showInstructions(ScreenBuffer& buffer);
+    static void showLoseScreen(ScreenBuffer& buffer);
+    static void showWinScreen(ScreenBuffer& buffer);
     
     // Save/Load game state UI
-    static bool showSaveDialog(std::string& saveName);
-    static std::string showLoadDialog();  // Returns empty string if cancelled, or save file path
+    static bool showSaveDialog(ScreenBuffer& buffer, std::string& saveName);
+    static std::string showLoadDialog(ScreenBuffer& buffer);  // Returns empty string if cancelled, or save file path
     
     // Helper to draw start menu without waiting for input
-    static void drawStartMenu();
+    static void drawStartMenu(ScreenBuffer& buffer);
     
     // UI Screen Templates (cached)
     static const std::vector<std::string>& getRiddleTemplate();
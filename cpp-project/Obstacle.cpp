@@ -3,8 +3,8 @@
 #include "Glyph.h"
 #include "Game.h"
 #include "RoomConnections.h"
-#include <queue>
-#include <set>
+#include <algorithm>
+#include <utility>
 
 // Helper: map dx,dy to Direction for room crossing
 static Direction dirFromDelta(int dx, int dy) {
@@ -15,69 +15,86 @@ static Direction dirFromDelta(int dx, int dy) {
     return Direction::None;
 }
 
-bool Obstacle::canPush(int dx, int dy, int force, Game& game, int speed) const {
-    // Require enough force equal to obstacle size
-    if (force < size()) return false;
+// One push step of a cell: dx, dy further, or past the screen edge into the connected room,
+// 3 cells inward from its opposite edge. False if no room is connected that way.
+static bool stepCell(ObCell& c, int dx, int dy, Game& game) {
+    int nx = c.getPos().getX() + dx;
+    int ny = c.getPos().getY() + dy;
+    int room = c.getRoomIdx();
 
+    if (nx < 0 || nx >= Screen::MAX_X || ny < 0 || ny >= Screen::MAX_Y) {
+        room = game.getTargetRoom(room, dirFromDelta(dx, dy));
+        if (room < 0 || room >= game.getWorldSize()) return false;
+        if (nx < 0) nx = Screen::MAX_X - 4; // 3 cells from right edge
+        else if (nx >= Screen::MAX_X) nx = 3; // 3 cells from left edge
+        if (ny < 0) ny = Screen::MAX_Y - 4; // 3 cells from bottom edge
+        else if (ny >= Screen::MAX_Y) ny = 3; // 3 cells from top edge
+    }
 
-    // Build a quick lookup of current cells positions per room to allow self-overlap during move
-    // (when translating rigidly, interior cells move into positions vacated by other cells of the same obstacle)
-    auto isOwnCellAt = [&](int room, const Point& p) -> bool {
-        for (const auto& c : cells) {
-            if (c.getRoomIdx() == room && c.getPos().getX() == p.getX() && c.getPos().getY() == p.getY()) 
-                return true;
-        }
-        return false;
-    };
+    c.setPos(Point(nx, ny));
+    c.setRoomIdx(room);
+    return true;
+}
 
-    // Check every cell's destination is valid for the entire speed distance
-    for (const auto& c : cells) {
-        int nx = c.getPos().getX() + dx * speed; // multiply by speed
-        int ny = c.getPos().getY() + dy * speed;
-        int room = c.getRoomIdx();
-
-        // Handle crossing room borders: obstacles can cross rooms
-        // Note: multi-step may cross multiple rooms, but for simplicity we handle one crossing
-        if (nx < 0 || nx >= Screen::MAX_X || ny < 0 || ny >= Screen::MAX_Y) {
-            Direction d = dirFromDelta(dx, dy);
-            int targetRoom = game.getTargetRoom(room, d);
-            if (targetRoom == -1) return false; // no connection -> blocked
-            // Wrap position to 3 cells inward from opposite edge (same as applyPush)
-            if (nx < 0) nx = Screen::MAX_X - 4;
-            else if (nx >= Screen::MAX_X) nx = 3;
-            if (ny < 0) ny = Screen::MAX_Y - 4;
-            else if (ny >= Screen::MAX_Y) ny = 3;
-            room = targetRoom;
-        }
+// The part of a room -> cells list for room (added empty if missing)
+static CellMask& partFor(std::vector<std::pair<int, CellMask>>& parts, int room) {
+    for (auto& part : parts) {
+        if (part.first == room) return part.second;
+    }
+    parts.push_back({ room, CellMask() });
+    return parts.back().second;
+}
 
-        Screen& s = game.getScreen(room);
-        Point np(nx, ny);
+bool Obstacle::canPush(int dx, int dy, int force, const Game& game, int speed) const {
+    // Require enough force equal to obstacle size
+    if (force < size()) return false;
+    if (dx == 0 && dy == 0) return true; // Nothing moves
 
-        // Block if a player is standing at the destination cell in that room
-        for (const auto& pl : game.getPlayers()) {
-            if (pl.getRoomIdx() == room) {
-                Point pp = pl.getPosition();
-                if (pp.getX() == np.getX() && pp.getY() == np.getY()) {
-                    return false;
-                }
-            }
-        }
+    // Membership bitmap of the obstacle in each room it covers. Its own cells count as free
+    // (when translating rigidly, cells move into positions vacated by other cells of the obstacle).
+    std::vector<std::pair<int, CellMask>> own;
+    for (const auto& c : cells) {
+        partFor(own, c.getRoomIdx()).set(c.getPos());
+    }
 
-        wchar_t ch = s.getCharAt(np);
+    // Pushes are along one axis: cells on the leading edge leave the room each step
+    const Direction dir = dirFromDelta(dx, dy);
+    const CellMask leadingEdge = dx > 0 ? CellMask::column(Screen::MAX_X - 1)
+                               : dx < 0 ? CellMask::column(0)
+                               : dy > 0 ? CellMask::row(Screen::MAX_Y - 1)
+                                        : CellMask::row(0);
+    // ...and land 3 cells inward from the opposite edge of the next room (as in stepCell)
+    const int wrapDx = dx > 0 ? 3 - (Screen::MAX_X - 1) : dx < 0 ? Screen::MAX_X - 4 : 0;
+    const int wrapDy = dx != 0 ? 0 : dy > 0 ? 3 - (Screen::MAX_Y - 1) : Screen::MAX_Y - 4;
 
-        // Walls and doors always block
-        if (Glyph::isWall(ch) || Glyph::isDoor(ch)) return false;
+    // Move the bitmaps one cell per step of the speed; every cell they pass must be free
+    std::vector<std::pair<int, CellMask>> at = own;
+    std::vector<std::pair<int, CellMask>> next;
+    for (int step = 0; step < speed; ++step) {
+        next.clear();
+        for (const auto& [room, part] : at) {
+            CellMask stays = part.shifted(dx, dy);
+            if (stays.any()) partFor(next, room) |= stays;
 
-        // If destination has another obstacle cell:
-        // allow only if it belongs to THIS obstacle (self-overlap during rigid move)
-        if (Glyph::isObstacle(ch)) {
-            if (!isOwnCellAt(room, np)) return false; // other obstacle blocks
-            // else it's our own current cell which will vacate; allowed
-            continue;
+            CellMask leaving = part & leadingEdge;
+            if (!leaving.any()) continue;
+            int targetRoom = game.getTargetRoom(room, dir);
+            if (targetRoom < 0 || targetRoom >= game.getWorldSize()) return false; // no connection -> blocked
+            partFor(next, targetRoom) |= leaving.shifted(wrapDx, wrapDy);
         }
 
-        // Otherwise require empty space
-        if (ch != Glyph::Empty) return false;
+        for (const auto& [room, part] : next) {
+            const Screen& s = game.getScreen(room);
+            // A player standing there (the player masks follow every move), or anything drawn there that is not this obstacle
+            // (walls, doors, other obstacles, items) blocks
+            if (part.intersects(s.getPlayerMask())) return false;
+            CellMask taken = s.getOccupiedMask();
+            for (const auto& [ownRoom, ownPart] : own) {
+                if (ownRoom == room) taken &= ~ownPart;
+            }
+            if (part.intersects(taken)) return false;
+        }
+        std::swap(at, next);
     }
 
     return true;
@@ -92,27 +109,15 @@ void Obstacle::applyPush(int dx, int dy, Game& game, int speed) {
         s.refreshCell(c.getPos()); // update console immediately so obstacle doesn't appear "swallowed"
     }
 
-    // Perform movement by speed steps, including room crossing
-    for (auto& c : cells) {
-        int nx = c.getPos().getX() + dx * speed; // multiply by speed
-        int ny = c.getPos().getY() + dy * speed;
-        int room = c.getRoomIdx();
-
-        if (nx < 0 || nx >= Screen::MAX_X || ny < 0 || ny >= Screen::MAX_Y) {
-            Direction d = dirFromDelta(dx, dy);
-            int targetRoom = game.getTargetRoom(room, d);
-            // Assuming canPush already verified targetRoom != -1
-            // Spawn obstacle 3 cells inward from edge
-            if (nx < 0) nx = Screen::MAX_X - 4; // 3 cells from right edge
-            else if (nx >= Screen::MAX_X) nx = 3; // 3 cells from left edge
-            if (ny < 0) ny = Screen::MAX_Y - 4; // 3 cells from bottom edge
-            else if (ny >= Screen::MAX_Y) ny = 3; // 3 cells from top edge
-            room = targetRoom;
+    // Perform movement by speed steps, including room crossings (canPush verified every step)
+    std::vector<ObCell> moved = cells;
+    for (auto& c : moved) {
+        for (int step = 0; step < speed; ++step) {
+            stepCell(c, dx, dy, game);
         }
-
-        c.setPos(Point(nx, ny));
-        c.setRoomIdx(room);
     }
+    ObstacleRegistry& registry = game.getObstacles();
+    registry.move(id, moved);
 
     // Draw obstacle at new positions only if in visible room
     int visibleRoom = game.getVisibleRoomIdx();
@@ -125,104 +130,206 @@ void Obstacle::applyPush(int dx, int dy, Game& game, int speed) {
         }
         // If not visible, it will be drawn when room is switched
     }
+
+    // Last: regrouping may reallocate the registry this obstacle lives in
+    registry.regroup(id, game.getRoomConnections());
 }
 
 
-void Obstacle::scanAllObstacles(std::vector<Screen>& world, const RoomConnections& roomConnections) {
-    using std::vector;
-    using std::queue;
-    using std::pair;
-    using std::set;
-    
+void Obstacle::scanAllObstacles(std::vector<Screen>& world, const RoomConnections& roomConnections,
+                                ObstacleRegistry& registry) {
     // Clear all obstacles first
-    for (int room = 0; room < (int)world.size(); ++room) {
-        world[room].getDataMutable().obstacles.clear();
+    registry.reset((int)world.size());
+
+    // Obstacle cells not assigned to an obstacle yet, per room
+    std::vector<CellMask> unvisited;
+    unvisited.reserve(world.size());
+    for (const auto& s : world) {
+        unvisited.push_back(s.getObstacleMask());
     }
 
-    vector<vector<vector<bool>>> visited(world.size(), 
-        vector<vector<bool>>(Screen::MAX_Y, vector<bool>(Screen::MAX_X, false)));
-    
+    // A component that reaches a screen edge continues on the opposite edge of the connected room
+    struct Edge {
+        CellMask cells;
+        Direction dir;
+        int dx, dy;  // Moves the edge cells onto the opposite edge
+    };
+    const Edge edges[4] = {
+        { CellMask::column(0), Direction::Left, Screen::MAX_X - 1, 0 },
+        { CellMask::column(Screen::MAX_X - 1), Direction::Right, -(Screen::MAX_X - 1), 0 },
+        { CellMask::row(0), Direction::Up, 0, Screen::MAX_Y - 1 },
+        { CellMask::row(Screen::MAX_Y - 1), Direction::Down, 0, -(Screen::MAX_Y - 1) },
+    };
+
     for (int room = 0; room < (int)world.size(); ++room) {
-        Screen& s = world[room];
-        for (int y = 0; y < Screen::MAX_Y; ++y) {
-            for (int x = 0; x < Screen::MAX_X; ++x) {
-                if (visited[room][y][x]) continue;
-                
-                Point start{ x, y };
-                wchar_t c = s.getCharAt(start);
-                if (!Glyph::isObstacle(c)) continue;
-                
-                queue<pair<int, Point>> q;
-                q.push({ room, start });
-                visited[room][y][x] = true;
-                vector<ObCell> component;
-                
-                auto enqueue = [&](int r, Point p) {
-                    if (r < 0 || r >= (int)world.size()) return;
-                    if (p.getX() < 0 || p.getX() >= Screen::MAX_X || p.getY() < 0 || p.getY() >= Screen::MAX_Y) return;
-                    if (visited[r][p.getY()][p.getX()]) return;
-                    if (!Glyph::isObstacle(world[r].getCharAt(p))) return;
-                    visited[r][p.getY()][p.getX()] = true;
-                    q.push({ r, p });
-                };
-                
-                while (!q.empty()) {
-                    auto cur = q.front();
-                    q.pop();
-                    int cr = cur.first;
-                    Point cp = cur.second;
-                    component.push_back(ObCell(cr, cp));
-                    
-                    const int dx[4] = { 1, -1, 0, 0 };
-                    const int dy[4] = { 0, 0, 1, -1 };
-                    
-                    for (int i = 0; i < 4; ++i) {
-                        Point np(cp.getX() + dx[i], cp.getY() + dy[i]);
-                        int nr = cr;
-                        
-                        if (np.getX() < 0) {
-                            nr = roomConnections.getTargetRoom(cr, Direction::Left);
-                            np.setX(Screen::MAX_X - 1);
-                        }
-                        else if (np.getX() >= Screen::MAX_X) {
-                            nr = roomConnections.getTargetRoom(cr, Direction::Right);
-                            np.setX(0);
-                        }
-                        else if (np.getY() < 0) {
-                            nr = roomConnections.getTargetRoom(cr, Direction::Up);
-                            np.setY(Screen::MAX_Y - 1);
-                        }
-                        else if (np.getY() >= Screen::MAX_Y) {
-                            nr = roomConnections.getTargetRoom(cr, Direction::Down);
-                            np.setY(0);
-                        }
-                        
-                        if (nr == -1) continue;
-                        enqueue(nr, np);
-                    }
-                }
+        for (int first = unvisited[room].first(); first >= 0; first = unvisited[room].first()) {
+            // Flood the component room by room, a whole screen of cells per step
+            std::vector<std::pair<int, CellMask>> parts;  // Room -> cells of the component there
+            std::vector<std::pair<int, CellMask>> pending;
+            CellMask seed;
+            seed.set(first % Screen::MAX_X, first / Screen::MAX_X);
+            pending.push_back({ room, seed });
 
-                Obstacle obs(component);
+            while (!pending.empty()) {
+                auto [r, from] = pending.back();
+                pending.pop_back();
+                CellMask part = CellMask::flood(from, unvisited[r]);
+                if (!part.any()) continue;
+                unvisited[r] &= ~part;
 
-                set<int> roomsInvolved;
-                for (const auto& cell : component) {
-                    roomsInvolved.insert(cell.getRoomIdx());
-                }
-                for (int involvedRoom : roomsInvolved) {
-                    world[involvedRoom].getDataMutable().obstacles.push_back(obs);
+                auto it = std::find_if(parts.begin(), parts.end(), [r = r](const auto& p) { return p.first == r; });
+                if (it == parts.end()) parts.push_back({ r, part });
+                else it->second |= part;
+
+                for (const Edge& e : edges) {
+                    CellMask atEdge = part & e.cells;
+                    if (!atEdge.any()) continue;
+                    int nr = roomConnections.getTargetRoom(r, e.dir);
+                    if (nr < 0 || nr >= (int)world.size()) continue;
+                    pending.push_back({ nr, atEdge.shifted(e.dx, e.dy) });
                 }
             }
+
+            // Cells in room order, row-major within a room
+            std::sort(parts.begin(), parts.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            std::vector<ObCell> component;
+            for (const auto& part : parts) {
+                part.second.forEach([&](int x, int y) { component.push_back(ObCell(part.first, Point(x, y))); });
+            }
+
+            registry.add(component);
         }
     }
 }
 
-// Static: Find obstacle at position
-Obstacle* Obstacle::findAt(Screen& screen, int roomIdx, const Point& p) {
-    auto& data = screen.getDataMutable();
-    for (auto& o : data.obstacles) {
-        if (o.contains(roomIdx, p)) {
-            return &o;
+void ObstacleRegistry::reset(int roomCount) {
+    obstacles_.clear();
+    freeIds_.clear();
+    owners_.assign(roomCount, {});
+}
+
+int ObstacleRegistry::add(const std::vector<ObCell>& cells) {
+    int id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+        obstacles_[id] = Obstacle(cells);
+    } else {
+        id = (int)obstacles_.size();
+        obstacles_.push_back(Obstacle(cells));
+    }
+    obstacles_[id].id = id;
+    for (const ObCell& c : cells) setOwner(c, id);
+    return id;
+}
+
+void ObstacleRegistry::remove(int id) {
+    if (id < 0 || id >= (int)obstacles_.size() || obstacles_[id].id < 0) return;
+    for (const ObCell& c : obstacles_[id].cells) setOwner(c, -1);
+    obstacles_[id].cells.clear();
+    obstacles_[id].id = -1;
+    freeIds_.push_back(id);
+}
+
+Obstacle* ObstacleRegistry::findAt(int roomIdx, const Point& p) {
+    int id = idAt(roomIdx, p);
+    return id >= 0 ? &obstacles_[id] : nullptr;
+}
+
+int ObstacleRegistry::idAt(int roomIdx, const Point& p) const {
+    if (roomIdx < 0 || roomIdx >= (int)owners_.size()) return -1;
+    if (p.getX() < 0 || p.getX() >= Screen::MAX_X || p.getY() < 0 || p.getY() >= Screen::MAX_Y) return -1;
+    return (int)owners_[roomIdx][p.getY() * Screen::MAX_X + p.getX()] - 1;
+}
+
+void ObstacleRegistry::move(int id, const std::vector<ObCell>& newCells) {
+    // Old cells first: the new ones may overlap them
+    for (const ObCell& c : obstacles_[id].cells) setOwner(c, -1);
+    obstacles_[id].cells = newCells;
+    for (const ObCell& c : newCells) setOwner(c, id);
+}
+
+void ObstacleRegistry::setOwner(const ObCell& c, int id) {
+    int room = c.getRoomIdx();
+    Point p = c.getPos();
+    if (room < 0 || room >= (int)owners_.size()) return;
+    if (p.getX() < 0 || p.getX() >= Screen::MAX_X || p.getY() < 0 || p.getY() >= Screen::MAX_Y) return;
+    owners_[room][p.getY() * Screen::MAX_X + p.getX()] = (uint16_t)(id + 1);
+}
+
+void ObstacleRegistry::regroup(int id, const RoomConnections& roomConnections) {
+    // The 4 neighbours of a cell; across a screen edge, the opposite edge of the connected room
+    // (the same links scanAllObstacles follows)
+    auto forEachNeighbour = [&](const ObCell& c, auto f) {
+        const int x = c.getPos().getX(), y = c.getPos().getY(), room = c.getRoomIdx();
+        const struct { int dx, dy; Direction dir; } steps[4] = {
+            { -1, 0, Direction::Left }, { 1, 0, Direction::Right }, { 0, -1, Direction::Up }, { 0, 1, Direction::Down },
+        };
+        for (const auto& s : steps) {
+            int nx = x + s.dx, ny = y + s.dy, nr = room;
+            if (nx < 0 || nx >= Screen::MAX_X || ny < 0 || ny >= Screen::MAX_Y) {
+                nr = roomConnections.getTargetRoom(room, s.dir);
+                if (nr < 0 || nr >= (int)owners_.size()) continue;
+                nx = (nx + Screen::MAX_X) % Screen::MAX_X;
+                ny = (ny + Screen::MAX_Y) % Screen::MAX_Y;
+            }
+            f(nr, Point(nx, ny));
         }
+    };
+
+    // The moved obstacle and every obstacle it touches
+    std::vector<int> group{ id };
+    for (const ObCell& c : obstacles_[id].cells) {
+        forEachNeighbour(c, [&](int room, const Point& p) {
+            int other = idAt(room, p);
+            if (other >= 0 && std::find(group.begin(), group.end(), other) == group.end()) group.push_back(other);
+        });
+    }
+
+    // Their cells split into connected parts, the part with the moved obstacle's first cell first
+    std::vector<ObCell> pool;
+    for (int g : group) {
+        pool.insert(pool.end(), obstacles_[g].cells.begin(), obstacles_[g].cells.end());
+    }
+    std::vector<std::pair<int, int>> poolIndex;  // (room * CELLS + cell, index in pool), sorted
+    poolIndex.reserve(pool.size());
+    for (int i = 0; i < (int)pool.size(); ++i) {
+        const Point p = pool[i].getPos();
+        poolIndex.push_back({ pool[i].getRoomIdx() * CELLS + p.getY() * Screen::MAX_X + p.getX(), i });
     }
-    return nullptr;
-}
\ No newline at end of file
+    std::sort(poolIndex.begin(), poolIndex.end());
+
+    std::vector<std::vector<ObCell>> parts;
+    std::vector<bool> assigned(pool.size(), false);
+    std::vector<int> pending;
+    for (int start = 0; start < (int)pool.size(); ++start) {
+        if (assigned[start]) continue;
+        parts.emplace_back();
+        assigned[start] = true;
+        pending.push_back(start);
+        while (!pending.empty()) {
+            int i = pending.back();
+            pending.pop_back();
+            parts.back().push_back(pool[i]);
+            forEachNeighbour(pool[i], [&](int room, const Point& p) {
+                auto it = std::lower_bound(poolIndex.begin(), poolIndex.end(),
+                                           std::make_pair(room * CELLS + p.getY() * Screen::MAX_X + p.getX(), -1));
+                if (it == poolIndex.end() || it->first != room * CELLS + p.getY() * Screen::MAX_X + p.getX()) return;
+                if (!assigned[it->second]) {
+                    assigned[it->second] = true;
+                    pending.push_back(it->second);
+                }
+            });
+        }
+    }
+
+    if (group.size() == 1 && parts.size() == 1) return;  // Still on its own and in one piece
+
+    for (int g : group) {
+        if (g != id) remove(g);
+    }
+    move(id, parts[0]);
+    for (size_t i = 1; i < parts.size(); ++i) {
+        add(parts[i]);
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "Point.h"
+#include <array>
+#include <cstdint>
 #include <vector>
 
 class ObCell { 
@@ -19,9 +21,12 @@ public:
 
 // Represents an obstacle made of contiguous '*' cells (4-neighborhood), possibly across rooms.
 class Obstacle {
+    int id = -1;               // Slot in the ObstacleRegistry
     std::vector<ObCell> cells; // absolute positions with room index
+    friend class ObstacleRegistry;
 public:
     Obstacle(const std::vector<ObCell>& pts) : cells(pts) {}
+    int getId() const { return id; }
     int size() const { return (int)cells.size(); }
     const std::vector<ObCell>& getCells() const { return cells; }
 
@@ -34,12 +39,55 @@ public:
     }
 
     // Attempt push by dx,dy with given speed (number of steps). Requires force >= size.
-    bool canPush(int dx, int dy, int force, class Game& game, int speed = 1) const;
+    bool canPush(int dx, int dy, int force, const class Game& game, int speed = 1) const;
+    // Moves the obstacle in the game's registry; may merge or split it, so `this` must not be used afterwards
     void applyPush(int dx, int dy, class Game& game, int speed = 1);
     
     // Static method to scan all obstacles in the world
-    static void scanAllObstacles(std::vector<class Screen>& world, const class RoomConnections& roomConnections);
-    
-    // Static: Find obstacle at position in a screen
-    static Obstacle* findAt(class Screen& screen, int roomIdx, const Point& p);
+    static void scanAllObstacles(std::vector<class Screen>& world, const class RoomConnections& roomConnections,
+                                 class ObstacleRegistry& registry);
+};
+
+// Every obstacle of the world, listed once under an id that stays the same while it moves,
+// plus a per-room cell -> id map. Pushes and explosions update it in place, touching only the
+// cells of the obstacles involved.
+class ObstacleRegistry {
+public:
+    static constexpr int CELLS = 80 * 25;
+
+    // Drop all obstacles
+    void reset(int roomCount);
+
+    int add(const std::vector<ObCell>& cells);
+    void remove(int id);
+
+    // nullptr if id was removed
+    Obstacle* get(int id) { return (id >= 0 && id < (int)obstacles_.size() && obstacles_[id].id >= 0) ? &obstacles_[id] : nullptr; }
+
+    // nullptr / -1 if no obstacle covers the cell
+    Obstacle* findAt(int roomIdx, const Point& p);
+    int idAt(int roomIdx, const Point& p) const;
+
+    // Give obstacle id the cells newCells (the screens are redrawn by the caller)
+    void move(int id, const std::vector<ObCell>& newCells);
+
+    // After obstacle id moved: merge it with the obstacles it now touches and split it where a
+    // room crossing left it disconnected, so obstacles stay the connected groups a full scan finds.
+    // The part holding its first cell keeps the id.
+    void regroup(int id, const class RoomConnections& roomConnections);
+
+    // Live obstacles in id order
+    template <class F>
+    void forEach(F f) const {
+        for (const Obstacle& o : obstacles_) {
+            if (o.id >= 0) f(o);
+        }
+    }
+
+private:
+    std::vector<Obstacle> obstacles_;                    // Indexed by id; removed slots have id -1
+    std::vector<int> freeIds_;
+    std::vector<std::array<uint16_t, CELLS>> owners_;    // Per room: id + 1 at each cell, 0 = none
+
+    void setOwner(const ObCell& c, int id);
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <ctime>
+#include <cstddef>
+
+// Thin platform layer - the only place that talks to the OS console, clock and keyboard.
+// Everything else in the game is plain C++ and builds on any platform.
+// Platform_win.cpp implements it with windows.h/conio.h, Platform_posix.cpp with termios/unistd.
+class Platform {
+public:
+    // What one writeFrame did
+    struct FrameOutput {
+        int rowsScanned = 0;   // Rows (spans) compared with the previous frame
+        int rowsWritten = 0;   // Rows with at least one cell sent to the console
+        int cellsChanged = 0;  // Cells that differ from the previous frame
+        size_t bytes = 0;      // Bytes sent to the console
+        int writeCalls = 0;    // Output system calls
+    };
+
+    // Console setup (UTF-8 output, 80x25 window where the console supports it)
+    static void initConsole();
+
+    // Moves the console cursor to specific (x, y) coordinates
+    static void setCursorPosition(int x, int y);
+
+    // Hides the blinking cursor for a better game look
+    static void hideCursor();
+
+    // Clears the whole console window (screens are then drawn through a ScreenBuffer, which
+    // repaints everything on its first flush)
+    static void clearConsole();
+
+    // Writes a run of characters starting at (x, y)
+    static void writeAt(int x, int y, const wchar_t* text, int length);
+
+    // Cells [from, to) of row y
+    struct RowSpan {
+        int y = 0;
+        int from = 0;
+        int to = 0;
+    };
+
+    // Brings the console from one frame to the next, looking only at the given spans (sorted by row).
+    // Both frames are rows of `width` cells, and previous must be what is on the console now
+    // ('\0' cells are treated as unknown).
+    static FrameOutput writeFrame(const wchar_t* cells, const wchar_t* previous, int width,
+                                  const RowSpan* spans, int spanCount);
+
+    // Blocks the calling thread for the given number of milliseconds
+    static void sleepMs(int ms);
+
+    // Non-blocking check for a pending key press
+    static bool keyPressed();
+
+    // Reads one key press (blocks until one is available)
+    static int readKey();
+
+    // Converts UTF-8 text to a wide string
+    static std::wstring utf8ToWide(const std::string& text);
+
+    // Get executable directory for resource loading
+    static std::string getExeDirectory();
+
+    // Thread-safe localtime
+    static void localTime(std::time_t timestamp, std::tm& out);
+
+    // Runs a shell command and collects its standard output. Returns false if it could not
+    // be started or exited with a non-zero status.
+    static bool runCommand(const std::string& command, std::string& output);
+
+    // Quotes one argument (a path) for a runCommand shell string, so spaces and shell
+    // characters in it stay literal
+    static std::string quoteArgument(const std::string& argument);
+};
@@ -0,0 +1,364 @@
+#include "Platform.h"
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/select.h>
+
+// POSIX terminal implementation of the platform layer (VT escape sequences + termios)
+
+namespace {
+    termios g_savedTermios;
+    bool g_rawMode = false;
+    bool g_cursorHidden = false;
+
+    void restoreTerminal() {
+        if (g_rawMode) {
+            tcsetattr(STDIN_FILENO, TCSANOW, &g_savedTermios);
+            g_rawMode = false;
+        }
+        if (g_cursorHidden) {
+            std::cout << "\x1b[?25h" << std::flush;
+            g_cursorHidden = false;
+        }
+    }
+
+    // Key presses are read one at a time without echo, like _getch() on Windows
+    void enableRawMode() {
+        if (g_rawMode || !isatty(STDIN_FILENO)) return;
+        if (tcgetattr(STDIN_FILENO, &g_savedTermios) != 0) return;
+        termios raw = g_savedTermios;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0) {
+            g_rawMode = true;
+            std::atexit(restoreTerminal);
+        }
+    }
+
+    void appendUtf8(std::string& out, wchar_t ch) {
+        unsigned long cp = (unsigned long)ch;
+        if (cp < 0x80) {
+            out.push_back((char)cp);
+        } else if (cp < 0x800) {
+            out.push_back((char)(0xC0 | (cp >> 6)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back((char)(0xE0 | (cp >> 12)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back((char)(0xF0 | (cp >> 18)));
+            out.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    int utf8Length(wchar_t ch) {
+        unsigned long cp = (unsigned long)ch;
+        return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+    }
+
+    int digitCount(int n) {
+        int digits = 1;
+        while (n >= 10) { n /= 10; ++digits; }
+        return digits;
+    }
+
+    // Control sequence ESC [ n final; n is left out when it is 1, the default of every sequence used here
+    void appendCsi(std::string& out, int n, char final) {
+        out += "\x1b[";
+        if (n != 1) out += std::to_string(n);
+        out.push_back(final);
+    }
+    int csiLength(int n) { return 3 + (n != 1 ? digitCount(n) : 0); }
+
+    // Builds the bytes that take the terminal from one frame to the next: only the changed spans,
+    // reached with the shortest cursor motion and with runs of one character sent as REP
+    class FrameEncoder {
+    public:
+        FrameEncoder(const wchar_t* cells, int width, std::string& out) : cells_(cells), width_(width), out_(out) {}
+
+        // Write cells [x, end) of row y
+        void writeSpan(int x, int end, int y) {
+            moveTo(x, y);
+            const wchar_t* row = cells_ + y * width_;
+            int i = x;
+            while (i < end) {
+                wchar_t ch = printable(row[i]);
+                int j = i + 1;
+                while (j < end && printable(row[j]) == ch) ++j;
+                appendUtf8(out_, ch);
+                int repeat = j - i - 1;
+                if (repeat > 0) {
+                    if (csiLength(repeat) < repeat * utf8Length(ch)) {
+                        appendCsi(out_, repeat, 'b');  // REP: the preceding character, repeat more times
+                    } else {
+                        for (int k = 0; k < repeat; ++k) appendUtf8(out_, ch);
+                    }
+                }
+                i = j;
+            }
+            // After the last column the cursor waits to wrap, and terminals disagree on where that is
+            if (end < width_) {
+                cursorX_ = end;
+                cursorY_ = y;
+            } else {
+                cursorX_ = cursorY_ = -1;
+            }
+        }
+
+    private:
+        const wchar_t* cells_;
+        int width_;
+        std::string& out_;
+        int cursorX_ = -1;  // Unknown at the start of a frame (other output may have moved it)
+        int cursorY_ = -1;
+
+        // Cells are single-column glyphs; a control character would move the cursor
+        static wchar_t printable(wchar_t ch) { return ch < 0x20 ? L' ' : ch; }
+
+        // Bytes to rewrite the cells of row y from column `from` up to `to` (they are already on screen)
+        int rewriteLength(int from, int to, int y) const {
+            int bytes = 0;
+            for (int x = from; x < to; ++x) bytes += utf8Length(printable(cells_[y * width_ + x]));
+            return bytes;
+        }
+
+        void moveTo(int x, int y) {
+            if (cursorX_ == x && cursorY_ == y) return;
+
+            // Absolute position (CUP) always works
+            int cupLength = 3 + (y != 0 || x != 0 ? digitCount(y + 1) : 0) + (x != 0 ? 1 + digitCount(x + 1) : 0);
+            if (cursorY_ < 0) {
+                appendCup(x, y);
+            } else {
+                // Otherwise the cheapest of: a vertical move (CUU/CUD), then to the column by
+                // carriage return, a relative move (CUF/CUB), an absolute column (CHA) or by
+                // rewriting the cells in between
+                int dy = y - cursorY_;
+                int vertical = dy == 0 ? 0 : csiLength(dy < 0 ? -dy : dy);
+                int dx = x - cursorX_;
+                int horizontal = 0;
+                char how = 0;
+                if (dx != 0) {
+                    horizontal = csiLength(x + 1);
+                    how = 'G';
+                    if (x == 0) { horizontal = 1; how = '\r'; }
+                    int relative = csiLength(dx < 0 ? -dx : dx);
+                    if (relative < horizontal) { horizontal = relative; how = dx < 0 ? 'D' : 'C'; }
+                    if (dx > 0) {
+                        int rewrite = rewriteLength(cursorX_, x, y);
+                        if (rewrite < horizontal) { horizontal = rewrite; how = 'w'; }
+                    }
+                }
+                if (vertical + horizontal >= cupLength) {
+                    appendCup(x, y);
+                } else {
+                    if (dy != 0) appendCsi(out_, dy < 0 ? -dy : dy, dy < 0 ? 'A' : 'B');
+                    if (how == '\r') {
+                        out_.push_back('\r');
+                    } else if (how == 'G') {
+                        appendCsi(out_, x + 1, 'G');
+                    } else if (how == 'C' || how == 'D') {
+                        appendCsi(out_, dx < 0 ? -dx : dx, how);
+                    } else if (how == 'w') {
+                        for (int k = cursorX_; k < x; ++k) appendUtf8(out_, printable(cells_[y * width_ + k]));
+                    }
+                }
+            }
+            cursorX_ = x;
+            cursorY_ = y;
+        }
+
+        void appendCup(int x, int y) {
+            out_ += "\x1b[";
+            if (y != 0 || x != 0) out_ += std::to_string(y + 1);
+            if (x != 0) { out_.push_back(';'); out_ += std::to_string(x + 1); }
+            out_.push_back('H');
+        }
+    };
+
+    // One write() for the whole frame (looping only if the terminal takes it in parts).
+    // Returns the number of write() calls.
+    int writeAll(const std::string& bytes) {
+        std::cout << std::flush;  // Keep the order of anything still buffered in std::cout
+        int calls = 0;
+        size_t done = 0;
+        while (done < bytes.size()) {
+            ssize_t n = write(STDOUT_FILENO, bytes.data() + done, bytes.size() - done);
+            ++calls;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            done += (size_t)n;
+        }
+        return calls;
+    }
+}
+
+void Platform::initConsole() {
+    // Terminal size and encoding are owned by the terminal emulator on POSIX
+}
+
+void Platform::setCursorPosition(int x, int y) {
+    std::cout << "\x1b[" << (y + 1) << ';' << (x + 1) << 'H' << std::flush;
+}
+
+void Platform::hideCursor() {
+    if (!g_cursorHidden) {
+        std::cout << "\x1b[?25l" << std::flush;
+        g_cursorHidden = true;
+        std::atexit(restoreTerminal);
+    }
+}
+
+void Platform::clearConsole() {
+    std::cout << "\x1b[2J\x1b[H" << std::flush;
+}
+
+void Platform::writeAt(int x, int y, const wchar_t* text, int length) {
+    std::string out;
+    out.reserve(16 + length * 3);
+    out += "\x1b[" + std::to_string(y + 1) + ";" + std::to_string(x + 1) + "H";
+    for (int i = 0; i < length; ++i) {
+        appendUtf8(out, text[i]);
+    }
+    std::cout << out << std::flush;
+}
+
+Platform::FrameOutput Platform::writeFrame(const wchar_t* cells, const wchar_t* previous, int width,
+                                           const RowSpan* spans, int spanCount) {
+    static std::string out;  // Reused from frame to frame
+    out.clear();
+    FrameOutput output;
+    output.rowsScanned = spanCount;
+    FrameEncoder encoder(cells, width, out);
+    for (int s = 0; s < spanCount; ++s) {
+        const int y = spans[s].y;
+        const wchar_t* row = cells + y * width;
+        const wchar_t* prevRow = previous + y * width;
+        bool rowWritten = false;
+        int x = spans[s].from;
+        while (x < spans[s].to) {
+            if (row[x] == prevRow[x]) { ++x; continue; }
+            int end = x + 1;
+            while (end < spans[s].to && row[end] != prevRow[end]) ++end;
+            encoder.writeSpan(x, end, y);
+            output.cellsChanged += end - x;
+            rowWritten = true;
+            x = end;
+        }
+        if (rowWritten) output.rowsWritten++;
+    }
+    if (!out.empty()) {
+        output.writeCalls = writeAll(out);
+        output.bytes = out.size();
+    }
+    return output;
+}
+
+void Platform::sleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+bool Platform::keyPressed() {
+    enableRawMode();
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(STDIN_FILENO, &readSet);
+    timeval timeout{ 0, 0 };
+    return select(STDIN_FILENO + 1, &readSet, nullptr, nullptr, &timeout) > 0;
+}
+
+int Platform::readKey() {
+    enableRawMode();
+    unsigned char ch = 0;
+    if (read(STDIN_FILENO, &ch, 1) != 1) return 0;
+    // Terminals send Enter as '\n' and Backspace as DEL; map them to the console codes
+    if (ch == '\n') return 13;
+    if (ch == 127) return 8;
+    return ch;
+}
+
+std::wstring Platform::utf8ToWide(const std::string& text) {
+    std::wstring result;
+    result.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = (unsigned char)text[i];
+        unsigned long cp;
+        int extra;
+        if (c < 0x80)               { cp = c;        extra = 0; }
+        else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; extra = 1; }
+        else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; extra = 2; }
+        else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; extra = 3; }
+        else { result.push_back(L'\xFFFD'); ++i; continue; }
+
+        if (i + extra >= text.size()) {
+            result.push_back(L'\xFFFD');
+            break;
+        }
+        bool valid = true;
+        for (int k = 1; k <= extra; ++k) {
+            unsigned char cc = (unsigned char)text[i + k];
+            if ((cc & 0xC0) != 0x80) { valid = false; break; }
+            cp = (cp << 6) | (cc & 0x3F);
+        }
+        if (!valid) {
+            result.push_back(L'\xFFFD');
+            ++i;
+            continue;
+        }
+        result.push_back((wchar_t)cp);
+        i += extra + 1;
+    }
+    return result;
+}
+
+std::string Platform::getExeDirectory() {
+    std::error_code ec;
+    std::filesystem::path exePath = std::filesystem::read_symlink("/proc/self/exe", ec);
+    if (ec || exePath.empty()) {
+        return std::filesystem::current_path().string();
+    }
+    return exePath.parent_path().string();
+}
+
+void Platform::localTime(std::time_t timestamp, std::tm& out) {
+    localtime_r(&timestamp, &out);
+}
+
+bool Platform::runCommand(const std::string& command, std::string& output) {
+    output.clear();
+    FILE* pipe = popen(command.c_str(), "r");
+    if (!pipe) return false;
+
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        output.append(buffer, n);
+    }
+    return pclose(pipe) == 0;
+}
+
+std::string Platform::quoteArgument(const std::string& argument) {
+    // Nothing is special inside single quotes; a quote itself closes, escapes and reopens them
+    std::string quoted = "'";
+    for (char c : argument) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
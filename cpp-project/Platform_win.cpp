@@ -0,0 +1,174 @@
+#include "Platform.h"
+#include <iostream>
+#include <filesystem>
+#include <cstdio>
+#include <windows.h>
+#include <conio.h>
+
+// This file base on Amir's tirgol
+
+void Platform::initConsole() {
+    SetConsoleOutputCP(65001);
+
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+
+    // On Windows Terminal the font is controlled by the host, skip font change
+    bool isWindowsTerminal = (GetEnvironmentVariableW(L"WT_SESSION", nullptr, 0) > 0);
+
+    if (!isWindowsTerminal) {
+        CONSOLE_FONT_INFOEX cfi{};
+        cfi.cbSize = sizeof(cfi);
+        cfi.nFont = 0;
+        cfi.dwFontSize.X = 0;   // Let the system pick width for the chosen height
+        cfi.dwFontSize.Y = 18;  // Reasonable height for readability
+        cfi.FontFamily = FF_DONTCARE;
+        cfi.FontWeight = FW_NORMAL;
+
+        // Prefer a TrueType font that supports Unicode box drawing
+        wcscpy_s(cfi.FaceName, L"Consolas");
+        if (!SetCurrentConsoleFontEx(hConsole, FALSE, &cfi)) {
+            // Fallback
+            wcscpy_s(cfi.FaceName, L"Lucida Console");
+            SetCurrentConsoleFontEx(hConsole, FALSE, &cfi);
+        }
+    }
+
+    // Set console screen buffer size to match 80x25
+    COORD bufferSize;
+    bufferSize.X = 80;
+    bufferSize.Y = 25;
+    SetConsoleScreenBufferSize(hConsole, bufferSize);
+
+    // Set window size
+    SMALL_RECT windowSize;
+    windowSize.Left = 0;
+    windowSize.Top = 0;
+    windowSize.Right = 79;  // 80 columns (0-79)
+    windowSize.Bottom = 24; // 25 rows (0-24)
+    SetConsoleWindowInfo(hConsole, TRUE, &windowSize);
+}
+
+void Platform::setCursorPosition(int x, int y) {
+    std::cout.flush();
+    COORD coord;
+    coord.X = (SHORT)x;
+    coord.Y = (SHORT)y;
+    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+}
+
+void Platform::hideCursor() {
+    HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    CONSOLE_CURSOR_INFO curInfo;
+    GetConsoleCursorInfo(hStdOut, &curInfo);
+    curInfo.bVisible = FALSE;
+    SetConsoleCursorInfo(hStdOut, &curInfo);
+}
+
+void Platform::clearConsole() {
+    // Blank the whole console buffer in place (no "cls" process)
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(hConsole, &info)) return;
+    DWORD cells = (DWORD)info.dwSize.X * (DWORD)info.dwSize.Y;
+    COORD home{ 0, 0 };
+    DWORD written;
+    FillConsoleOutputCharacterW(hConsole, L' ', cells, home, &written);
+    FillConsoleOutputAttribute(hConsole, info.wAttributes, cells, home, &written);
+    SetConsoleCursorPosition(hConsole, home);
+}
+
+void Platform::writeAt(int x, int y, const wchar_t* text, int length) {
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    COORD pos{ (SHORT)x, (SHORT)y };
+    SetConsoleCursorPosition(hConsole, pos);
+    DWORD written;
+    WriteConsoleW(hConsole, text, (DWORD)length, &written, nullptr);
+}
+
+// One writeAt per span with a change, from its first changed cell to its last; each is two console
+// calls (SetConsoleCursorPosition and WriteConsoleW), and both count as output calls
+Platform::FrameOutput Platform::writeFrame(const wchar_t* cells, const wchar_t* previous, int width,
+                                           const RowSpan* spans, int spanCount) {
+    FrameOutput output;
+    output.rowsScanned = spanCount;
+    for (int s = 0; s < spanCount; ++s) {
+        const RowSpan& span = spans[s];
+        const wchar_t* row = cells + span.y * width;
+        const wchar_t* prevRow = previous + span.y * width;
+        int first = -1, last = -1, changed = 0;
+        for (int x = span.from; x < span.to; ++x) {
+            if (row[x] != prevRow[x]) {
+                if (first < 0) first = x;
+                last = x;
+                ++changed;
+            }
+        }
+        if (changed > 0) {
+            int length = last - first + 1;
+            writeAt(first, span.y, row + first, length);
+            output.cellsChanged += changed;
+            output.rowsWritten++;
+            output.bytes += length * sizeof(wchar_t);  // WriteConsoleW takes UTF-16
+            output.writeCalls += 2;  // Cursor move and write, as in writeAt
+        }
+    }
+    return output;
+}
+
+void Platform::sleepMs(int ms) {
+    Sleep((DWORD)ms);
+}
+
+bool Platform::keyPressed() {
+    return _kbhit() != 0;
+}
+
+int Platform::readKey() {
+    return _getch();
+}
+
+std::wstring Platform::utf8ToWide(const std::string& text) {
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), nullptr, 0);
+    std::wstring wtext(wlen, 0);
+    if (wlen > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), &wtext[0], wlen);
+    }
+    return wtext;
+}
+
+std::string Platform::getExeDirectory() {
+    wchar_t buffer[MAX_PATH];
+    DWORD len = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
+    if (len == 0) {
+        return std::filesystem::current_path().string();
+    }
+    std::filesystem::path exePath(buffer);
+    return exePath.parent_path().string();
+}
+
+void Platform::localTime(std::time_t timestamp, std::tm& out) {
+    localtime_s(&out, &timestamp);
+}
+
+bool Platform::runCommand(const std::string& command, std::string& output) {
+    output.clear();
+    // cmd.exe strips the outer quotes, so a quoted program path needs another pair around it
+    FILE* pipe = _popen(("\"" + command + "\"").c_str(), "r");
+    if (!pipe) return false;
+
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        output.append(buffer, n);
+    }
+    return _pclose(pipe) == 0;
+}
+
+std::string Platform::quoteArgument(const std::string& argument) {
+    // Windows paths cannot hold a double quote, so a pair around it keeps spaces, & and | literal
+    std::string quoted = "\"";
+    for (char c : argument) {
+        if (c != '"') quoted += c;
+    }
+    return quoted + "\"";
+}
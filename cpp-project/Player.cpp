@@ -3,13 +3,13 @@
 #include <cctype>
 #include "Screen.h"
 #include "Glyph.h"
-#include <windows.h>
 #include "Game.h"
 #include "Obstacle.h"
 #include "Spring.h"
 #include "Switch.h"
 #include "SpecialDoor.h"
 #include "DarkRoom.h"
+#include "StateHash.h"
 
 namespace {
     constexpr int ADJACENT_DISTANCE = 1;
@@ -36,14 +36,48 @@ Player::Player(Point startPos, const char* keySet, wchar_t sym, int startRoom)
   ||    (__)
   ||w--||                    */
 
-void Player::draw() const {
-    ScreenBuffer::getInstance().setChar(position.getX(), position.getY(), symbol);
+void Player::draw(ScreenBuffer& buffer) const {
+    buffer.setChar(position.getX(), position.getY(), symbol);
 }
 
 void Player::stop() {
     position.setDirection(MoveDirection::Stay);
 }
 
+Player::IdleState Player::idleState() const {
+    IdleState state;
+    state.x = position.getX();
+    state.y = position.getY();
+    state.diffX = position.getDiffX();
+    state.diffY = position.getDiffY();
+    state.moved = movedThisFrame;
+    state.roomIdx = currentRoomIdx;
+    state.carried = carried.get();
+    state.actionRequested = actionRequested;
+    state.spring = currentSpring;
+    state.entryIndex = entryIndex;
+    state.compressedCount = compressedCount;
+    state.boostTicksLeft = springBoostTicksLeft;
+    state.boostSpeed = springBoostSpeed;
+    state.boostDirX = boostDirX;
+    state.boostDirY = boostDirY;
+    return state;
+}
+
+unsigned long long Player::stateHash() const {
+    unsigned long long h = StateHash::mix((unsigned long long)currentRoomIdx);
+    for (int v : { position.getX(), position.getY(), position.getDiffX(), position.getDiffY(),
+                   (int)movedThisFrame, (int)carried.get(), (int)actionRequested, entryIndex, compressedCount,
+                   springBoostTicksLeft, springBoostSpeed, boostDirX, boostDirY }) {
+        h = StateHash::combine(h, (unsigned long long)(long long)v);
+    }
+    if (currentSpring) {
+        h = StateHash::combine(h, (unsigned long long)currentSpring->getRoomIdx());
+        h = StateHash::combine(h, StateHash::cell(currentSpring->getWallPos().getX(), currentSpring->getWallPos().getY(), 0));
+    }
+    return h;
+}
+
 void Player::move(Screen& currentScreen, Game& game) {
     // Reset moved flag at start
     movedThisFrame = false;
@@ -210,6 +244,8 @@ bool Player::handleSpringPerpendicularMove(Screen& currentScreen, Game& game, co
 }
 
 void Player::tryCollectItem(Screen& currentScreen, Game& game, wchar_t tile) {
+    if (!Glyph::isCollectible(tile)) return;
+
     if (Glyph::isKey(tile)) {
         if (canTakeObject()) {
             setCarried((char)tile);
@@ -325,6 +361,7 @@ bool Player::processBoostMovement(Screen& currentScreen, Game& game, const Point
         
         if (Glyph::isObstacle(tile)) {
             Obstacle* obs = game.findObstacleAt(currentRoomIdx, next);
+            game.updatePlayerOccupancy(*this);  // This player has moved since the tick began
             if (obs && obs->canPush(boostDirX, boostDirY, stepForce, game, springBoostSpeed)) {
                 obs->applyPush(boostDirX, boostDirY, game, springBoostSpeed);
             } else {
@@ -406,8 +443,9 @@ bool Player::processNormalMovement(Screen& currentScreen, Game& game, const Poin
     else if (!DarkRoomManager::canEnterPosition(currentScreen, *this, targetPos, game.getPlayers(), currentRoomIdx)) {
         blocked = true;
     }
-    // Check if another player is at the target position
-    else {
+    // Check if another player is at the target position (the player mask, synced before this
+    // move, has no bit there in the common case; a set bit may still be this player itself)
+    else if (currentScreen.getPlayerMask().test(targetPos)) {
         for (const auto& other : game.getPlayers()) {
             if (&other == this) continue;
             if (other.getRoomIdx() != currentRoomIdx) continue;
@@ -427,6 +465,7 @@ bool Player::processNormalMovement(Screen& currentScreen, Game& game, const Poin
             SwitchData* sw = game.findSwitchAt(currentRoomIdx, targetPos);
             if (sw) {
                 sw->toggle();
+                game.switchToggled(currentRoomIdx, *sw);
                 currentScreen.setCharAt(targetPos, sw->getDisplayChar());
                 currentScreen.refreshCell(targetPos);
                 
@@ -498,6 +537,7 @@ bool Player::processNormalMovement(Screen& currentScreen, Game& game, const Poin
                         position = targetPos;
                         blocked = false;
                     } else if (getCarried() != NO_CARRIED_ITEM && door->useKey(Key(getCarried()))) {
+                        game.doorInputChanged(*door);
                         setCarried(NO_CARRIED_ITEM);
                         blocked = true;
                     } else {
@@ -514,9 +554,9 @@ bool Player::processNormalMovement(Screen& currentScreen, Game& game, const Poin
                     if (moveDx == 0 && moveDy == 0) {
                         blocked = true;
                     } else {
+                        game.updatePlayerOccupancy(*this);  // A spring may have moved this player
                         if (obs->canPush(moveDx, moveDy, appliedForce, game)) {
                             obs->applyPush(moveDx, moveDy, game);
-                            game.rescanObstacles();
                             wchar_t afterPush = currentScreen.getCharAt(targetPos);
                             if (afterPush == Glyph::Empty) {
                                 position = targetPos;
@@ -561,7 +601,7 @@ bool Player::processNormalMovement(Screen& currentScreen, Game& game, const Poin
                     currentScreen.setCharAt(position, Glyph::Empty);
                     currentScreen.refreshCell(position);
                 }
-            } else if (Glyph::isRiddle(tile) || tile == Glyph::Empty || Glyph::isPressureButton(tile)) {
+            } else if (tile == Glyph::Empty || Glyph::is(tile, Glyph::Tile::Riddle | Glyph::Tile::PressureButton)) {
                 position = targetPos;
             } else {
                 blocked = true;
@@ -636,7 +676,7 @@ void Player::handleItemAction(Screen& currentScreen, Game& game) {
         }
     } else {
         wchar_t under = currentScreen.getCharAt(position);
-        if ((Glyph::isKey(under) || Glyph::isTorch(under)) && canTakeObject()) {
+        if (Glyph::is(under, Glyph::Tile::Key | Glyph::Tile::Torch) && canTakeObject()) {
             setCarried((char)under);
             currentScreen.setCharAt(position, Glyph::Empty);
             currentScreen.refreshCell(position);
@@ -659,6 +699,7 @@ void Player::handleAdjacentDoorKeys(Screen& currentScreen, Game& game) {
         if (Glyph::isSpecialDoor(ch)) {
             auto* door = game.findSpecialDoorAt(currentRoomIdx, adj);
             if (door && door->useKey(Key(getCarried()))) {
+                game.doorInputChanged(*door);
                 setCarried(NO_CARRIED_ITEM);
                 break;
             }
@@ -26,7 +26,7 @@ bool actionRequested = false;
 
 public:
 Player(Point startPos, const char* keySet, wchar_t sym, int startRoom);
-void draw() const;
+void draw(ScreenBuffer& buffer) const;
 void move(Screen& currentScreen, class Game& game);
     
 // Handle key input - returns true if the key was meaningful (should be recorded)
@@ -35,6 +35,22 @@ bool handleKey(char key);
     
 void stop();
 bool isStationary() const { return position.getDiffX() == 0 && position.getDiffY() == 0; }
+// Every field that move() reads or writes, as plain values (compared to detect idle ticks)
+struct IdleState {
+    int x = 0, y = 0, diffX = 0, diffY = 0;
+    bool moved = false;
+    int roomIdx = 0;
+    char carried = 0;
+    bool actionRequested = false;
+    const class SpringData* spring = nullptr;
+    int entryIndex = 0, compressedCount = 0;
+    int boostTicksLeft = 0, boostSpeed = 0, boostDirX = 0, boostDirY = 0;
+
+    bool operator==(const IdleState&) const = default;
+};
+IdleState idleState() const;
+// Hash of the same fields (the spring by its wall position, not its address)
+unsigned long long stateHash() const;
     Key getCarriedKey() const { return carried; }
     char getCarried() const { return carried.get(); }
     void setCarried(char ch) { carried = Key(ch); }
@@ -49,6 +65,9 @@ bool isStationary() const { return position.getDiffX() == 0 && position.getDiffY
     bool hasMoved() const { return movedThisFrame; }
     void setMoved(bool moved) { movedThisFrame = moved; }
 
+    bool isActionRequested() const { return actionRequested; }
+    void setActionRequested(bool requested) { actionRequested = requested; }
+
     int getForce() const { return (springBoostTicksLeft > 0) ? springBoostSpeed : 1; }
     bool isSpringBoostActive() const { return springBoostTicksLeft > 0; }
     void inheritSpringLaunch(int speed, int ticks, int dirX, int dirY);
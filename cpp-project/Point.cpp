@@ -11,12 +11,12 @@ void Point::setDirection(MoveDirection dir) {
     }
 }
 
-void Point::draw(char ch) const {
+void Point::draw(ScreenBuffer& buffer, char ch) const {
     wchar_t wc;
     unsigned char uc = static_cast<unsigned char>(ch);
     // Preserve legacy mapping for specific CP437 codes
     if (uc == 148) wc = L'\u00F6'; // 
     else if (uc == 129) wc = L'\u00FC'; // 
     else wc = (wchar_t)uc;
-    ScreenBuffer::getInstance().setChar(x_, y_, wc);
+    buffer.setChar(x_, y_, wc);
 }
\ No newline at end of file
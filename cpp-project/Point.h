@@ -1,5 +1,4 @@
 #pragma once
-#include <windows.h>
 
 // Forward declaration to avoid circular include
 class ScreenBuffer;
@@ -55,5 +54,5 @@ public:
     void setDirection(MoveDirection dir);
 
     // Draw character to screen buffer (declared here, defined in Point.cpp)
-    void draw(char ch) const;
+    void draw(ScreenBuffer& buffer, char ch) const;
 };
\ No newline at end of file
@@ -14,12 +14,5 @@ void PressureButton::setTargets(const std::vector<Point>& points, const Screen&
 }
 
 PressureButton* PressureButton::findAt(Screen& screen, const Point& p) {
-    auto& data = screen.getDataMutable();
-    for (auto& sw : data.pressureButtons) {
-        Point swPos = sw.getPos();
-        if (swPos.getX() == p.getX() && swPos.getY() == p.getY()) {
-            return &sw;
-        }
-    }
-    return nullptr;
+    return screen.getEntityIndex().find(EntityIndex::PressureButton, screen.getDataMutable().pressureButtons, p);
 }
@@ -17,11 +17,31 @@ public:
     wchar_t getOriginalChar() const { return originalChar_; }
 };
 
+// A cell cleared by one or more pressure buttons of a room: empty while any of them is pressed,
+// its original glyph otherwise
+class PressureTargetCell {
+private:
+    Point pos_;
+    wchar_t originalChar_ = L' ';
+    int pressedCount_ = 0; // Pressed buttons clearing this cell
+
+public:
+    PressureTargetCell(Point p, wchar_t orig) : pos_(p), originalChar_(orig) {}
+
+    Point getPos() const { return pos_; }
+    wchar_t getOriginalChar() const { return originalChar_; }
+    int getPressedCount() const { return pressedCount_; }
+    void setPressedCount(int count) { pressedCount_ = count; }
+    void press() { ++pressedCount_; }
+    void release() { --pressedCount_; }
+};
+
 class PressureButton {
 private:
     int roomIdx_;
     Point pos_;
     std::vector<PressureButtonTarget> targets_;
+    std::vector<int> targetCells_; // Index of each target in the room's pressureTargets
 
 public:
     PressureButton(int room, Point p);
@@ -33,5 +53,8 @@ public:
 
     void setTargets(const std::vector<Point>& points, const Screen& screen);
 
+    const std::vector<int>& getTargetCells() const { return targetCells_; }
+    void addTargetCell(int cellIdx) { targetCells_.push_back(cellIdx); }
+
     static PressureButton* findAt(Screen& screen, const Point& p);
 };
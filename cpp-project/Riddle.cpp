@@ -3,12 +3,13 @@
 #include "Player.h"
 #include "Game.h"
 #include "Screen.h"
-#include "ScreenBuffer.h"
+#include "Board.h"
 #include "Menu.h"
 #include "Glyph.h"
 #include "GameRecorder.h"
 #include "utils.h"
-#include <conio.h>
+#include "Platform.h"
+#include <cstdio>
 #include <cstring>
 #include <string>
 #include <sstream>
@@ -34,11 +35,11 @@ Riddle::Riddle() : correctAnswer('1'), points(100)
 
 Riddle::Riddle(const char q[], const char a1[], const char a2[], const char a3[], const char a4[], char correct)
 {
-    strcpy_s(question, MAX_QUESTION_LENGTH, q);
-    strcpy_s(answer1, MAX_ANSWER_LENGTH, a1);
-    strcpy_s(answer2, MAX_ANSWER_LENGTH, a2);
-    strcpy_s(answer3, MAX_ANSWER_LENGTH, a3);
-    strcpy_s(answer4, MAX_ANSWER_LENGTH, a4);
+    std::snprintf(question, MAX_QUESTION_LENGTH, "%s", q);
+    std::snprintf(answer1, MAX_ANSWER_LENGTH, "%s", a1);
+    std::snprintf(answer2, MAX_ANSWER_LENGTH, "%s", a2);
+    std::snprintf(answer3, MAX_ANSWER_LENGTH, "%s", a3);
+    std::snprintf(answer4, MAX_ANSWER_LENGTH, "%s", a4);
     correctAnswer = correct;
     points = 100;
 }
@@ -92,7 +93,6 @@ void Riddle::handleEncounter(Player& player,
     int roomIdx = player.getRoomIdx();
     Point pos = player.getPosition();
     GameMode mode = game.getGameMode();
-    bool isSilent = (mode == GameMode::LoadSilent);
     bool isLoadMode = (mode == GameMode::Load || mode == GameMode::LoadSilent);
 
     // Find the riddle at this position
@@ -167,11 +167,9 @@ void Riddle::handleEncounter(Player& player,
                     // Explicitly remove the riddle glyph from the screen
                     game.getScreen(roomIdx).setCharAt(pos, Glyph::Empty);
 
-                    if (!isSilent) {
-                        // Force refresh of the cell to ensure it disappears visually
-                        game.getScreen(roomIdx).refreshCell(pos);
-                        ScreenBuffer::getInstance().flush();
-                    }
+                    // Force refresh of the cell to ensure it disappears visually
+                    game.getScreen(roomIdx).refreshCell(pos);
+                    game.getBoard().flush();
                 } else {
                     riddle->halvePoints();
                     game.reduceHearts(1);
@@ -201,18 +199,19 @@ void Riddle::handleEncounter(Player& player,
     vector<string> riddleScreenData = riddle->buildRiddleScreen(templateScreen); 
     Screen riddleScreen(riddleScreenData);
     
-    cls(); 
-    riddleScreen.draw();
+    Board& board = game.getBoard();
+    board.clearScreen(); 
+    board.drawScreen(riddleScreen);
     
     // Refresh legend (need to call through game)
     game.refreshLegendPublic();
-    ScreenBuffer::getInstance().flush();
+    board.flush();
 
     // Wait for player answer
     char answer = '\0';
     while (true) {
-        if (_kbhit()) {
-            answer = _getch();
+        if (Platform::keyPressed()) {
+            answer = (char)Platform::readKey();
             
             // ESC - cancel riddle
             if (answer == ESC_KEY) { 
@@ -255,6 +254,6 @@ void Riddle::handleEncounter(Player& player,
     }
 
     // Redraw game screen
-    cls(); 
+    board.clearScreen(); 
     game.drawEverythingPublic();
 }
\ No newline at end of file
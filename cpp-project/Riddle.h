@@ -63,6 +63,7 @@ public:
 	const char* getQuestion() const { return question; }
 	int getPoints() const { return points; }
 	void halvePoints() { points /= 2; }
+	void setPoints(int p) { points = p; }
 	
 	// Static method to scan all riddles from RiddleData
 	static void scanAllRiddles(std::map<RiddleKey, Riddle*>& riddlesByPosition);
@@ -1,5 +1,6 @@
 ﻿#include "Screen.h"
 #include "ScreenBuffer.h"
+#include "Board.h"
 #include <iostream>
 #include <cctype>
 #include "Point.h"
@@ -16,61 +17,127 @@
 #include "Legend.h"
 #include "RoomConnections.h"
 #include "FileParser.h"
+#include "Platform.h"
+#include "StateHash.h"
 
 // This file written by AI
 
 namespace fs = std::filesystem;
 
 void Screen::initFromWideLines(const std::vector<std::wstring>& lines) {
-    m_grid.clear();
-    m_grid.resize(MAX_Y, std::vector<SpecialChar>(MAX_X, SpecialChar{ Glyph::Empty }));
+    m_grid.fill(Glyph::Empty);
     int yLimit = std::min<int>(MAX_Y, (int)lines.size());
     for (int y = 0; y < yLimit; ++y) {
         const std::wstring& src = lines[y];
         int xLimit = std::min<int>(MAX_X, (int)src.size());
         for (int x = 0; x < xLimit; ++x) {
-            m_grid[y][x].ch = src[x];
+            m_grid[cellIndex(x, y)] = src[x];
         }
     }
+    recomputeStateHash();
+    rebuildCellMasks();
+}
+
+void Screen::recomputeStateHash() {
+    m_stateHash = 0;
+    for (int y = 0; y < MAX_Y; ++y) {
+        for (int x = 0; x < MAX_X; ++x) {
+            if (!isInMessageBox(Point(x, y))) {
+                m_stateHash ^= StateHash::cell(x, y, m_grid[cellIndex(x, y)]);
+            }
+        }
+    }
+}
+
+void Screen::rebuildCellMasks() {
+    m_blockingMask.clear();
+    m_obstacleMask.clear();
+    m_bombableMask.clear();
+    m_occupiedMask.clear();
+    m_torchMask.clear();
+    m_torches.clear();
+    for (int y = 0; y < MAX_Y; ++y) {
+        for (int x = 0; x < MAX_X; ++x) {
+            updateCellMasks(x, y, m_grid[cellIndex(x, y)]);
+        }
+    }
+}
+
+void Screen::updateCellMasks(int x, int y, wchar_t ch) {
+    unsigned short flags = Glyph::flags(ch);
+    m_blockingMask.set(x, y, (flags & Glyph::Tile::Blocking) != 0);
+    m_obstacleMask.set(x, y, Glyph::isObstacle(ch));
+    m_bombableMask.set(x, y, Glyph::isBombableWall(ch));
+    m_occupiedMask.set(x, y, ch != Glyph::Empty);
+
+    // Torches are picked up, dropped and blown up one cell at a time
+    bool torch = Glyph::isTorch(ch);
+    if (torch != m_torchMask.test(x, y)) {
+        m_torchMask.set(x, y, torch);
+        if (torch) {
+            m_torches.push_back(Point(x, y));
+        } else {
+            auto it = std::find_if(m_torches.begin(), m_torches.end(),
+                                   [x, y](const Point& t) { return t.getX() == x && t.getY() == y; });
+            *it = m_torches.back();
+            m_torches.pop_back();
+        }
+    }
+}
+
+void Screen::rebuildDarkMask() {
+    m_darkMask.clear();
+    for (const auto& zone : data_.getDarkZones()) {
+        m_darkMask |= CellMask::rect(zone.getTopLeft().getX(), zone.getTopLeft().getY(),
+                                     zone.getBottomRight().getX(), zone.getBottomRight().getY());
+    }
 }
 
 Screen::Screen(const std::vector<std::string>& mapData) {
     std::vector<std::wstring> widened;
     widened.reserve(mapData.size());
     for (auto& line : mapData) {
-        int wlen = MultiByteToWideChar(CP_UTF8,0,line.c_str(),(int)line.size(),nullptr,0);
-        std::wstring wline(wlen,0);
-        MultiByteToWideChar(CP_UTF8,0,line.c_str(),(int)line.size(),&wline[0],wlen);
-        widened.push_back(wline);
+        widened.push_back(Platform::utf8ToWide(line));
     }
     initFromWideLines(widened);
 }
 
-void Screen::draw() const {
-    ScreenBuffer& buffer = ScreenBuffer::getInstance();
+void Screen::draw(ScreenBuffer& buffer) const {
     for (int y = 0; y < MAX_Y; ++y) {
         for (int x = 0; x < MAX_X; ++x) {
-            buffer.setChar(x, y, m_grid[y][x].ch);
+            buffer.setChar(x, y, m_grid[cellIndex(x, y)]);
         }
     }
 }
 
-wchar_t Screen::getCharAt(const Point& p) const {
-    if (p.getX() < 0 || p.getX() >= MAX_X || p.getY() < 0 || p.getY() >= MAX_Y) return Glyph::Empty;
-    return m_grid[p.getY()][p.getX()].ch;
-}
-
 void Screen::setCharAt(const Point& p, wchar_t newChar) {
     if (p.getX() < 0 || p.getX() >= MAX_X || p.getY() < 0 || p.getY() >= MAX_Y) return;
-    m_grid[p.getY()][p.getX()].ch = newChar;
+    int index = cellIndex(p.getX(), p.getY());
+    if (m_grid[index] == newChar) return;
+    if (m_hasOriginal && !m_journaled.test(p)) {
+        m_journaled.set(p);
+        m_journal.push_back({ index, m_grid[index] });
+    }
+    writeCell(p.getX(), p.getY(), newChar);
+}
+
+void Screen::writeCell(int x, int y, wchar_t newChar) {
+    wchar_t& cell = m_grid[cellIndex(x, y)];
+    if (cell == newChar) return;
+    if (!isInMessageBox(Point(x, y))) {
+        m_stateHash ^= StateHash::cell(x, y, cell) ^ StateHash::cell(x, y, newChar);
+    }
+    cell = newChar;
+    updateCellMasks(x, y, newChar);
+    ++m_changeCount;
 }
 
 void Screen::erase(const Point& p) { setCharAt(p, Glyph::Empty); }
 
 void Screen::refreshCell(const Point& p) const {
+    if (!m_board) return;
     if (p.getX() < 0 || p.getX() >= MAX_X || p.getY() < 0 || p.getY() >= MAX_Y) return;
-    wchar_t c = m_grid[p.getY()][p.getX()].ch;
-    ScreenBuffer::getInstance().setChar(p.getX(), p.getY(), c);
+    m_board->refreshCell(*this, p);
 }
 
 void Screen::refreshCells(const std::vector<Point>& pts) const {
@@ -79,25 +146,37 @@ void Screen::refreshCells(const std::vector<Point>& pts) const {
 
 // Capture the current grid state as the "original" state for tracking modifications
 void Screen::captureOriginalState() {
-    m_originalGrid = m_grid;
+    m_journal.clear();
+    m_journaled.clear();
+    m_hasOriginal = true;
+    recomputeStateHash();  // The message box is known by now
 }
 
-// Get all modifications (differences from original state)
+void Screen::restoreOriginalState() {
+    if (!m_hasOriginal) return;
+    for (const auto& entry : m_journal) {
+        writeCell(entry.first % MAX_X, entry.first / MAX_X, entry.second);
+    }
+    m_journal.clear();
+    m_journaled.clear();
+    ++m_changeCount;
+}
+
+// Get all modifications (differences from original state), in row-major order
 std::vector<std::tuple<int, int, wchar_t>> Screen::getModifications() const {
     std::vector<std::tuple<int, int, wchar_t>> mods;
     
     // If no original state captured, return empty
-    if (m_originalGrid.empty()) {
+    if (!m_hasOriginal) {
         return mods;
     }
     
-    for (int y = 0; y < MAX_Y; ++y) {
-        for (int x = 0; x < MAX_X; ++x) {
-            wchar_t current = m_grid[y][x].ch;
-            wchar_t original = m_originalGrid[y][x].ch;
-            if (current != original) {
-                mods.push_back(std::make_tuple(x, y, current));
-            }
+    std::vector<std::pair<int, wchar_t>> touched = m_journal;
+    std::sort(touched.begin(), touched.end());
+    for (const auto& entry : touched) {
+        wchar_t current = m_grid[entry.first];
+        if (current != entry.second) {  // Cells changed back to the original are not modifications
+            mods.push_back(std::make_tuple(entry.first % MAX_X, entry.first / MAX_X, current));
         }
     }
     
@@ -150,10 +229,7 @@ Screen::LoadedScreen Screen::loadScreenFile(const std::string& filepath) {
     
     for (int i = 0; i < screenEndLine; ++i) {
         const std::string& srcLine = allLines[i];
-        int wlen = MultiByteToWideChar(CP_UTF8, 0, srcLine.c_str(), (int)srcLine.size(), nullptr, 0);
-        std::wstring wline(wlen, 0);
-        MultiByteToWideChar(CP_UTF8, 0, srcLine.c_str(), (int)srcLine.size(), &wline[0], wlen);
-        result.screenLines.push_back(wline);
+        result.screenLines.push_back(Platform::utf8ToWide(srcLine));
     }
     
     // Parse metadata if present
@@ -356,19 +432,18 @@ ScreenMetadata Screen::parseMetadata(const std::vector<std::string>& metadataLin
 
 // Helper: get executable directory for robust resource loading
 static fs::path getExeDir() {
-    wchar_t buffer[MAX_PATH];
-    DWORD len = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
-    if (len == 0) return fs::current_path();
-    fs::path exePath(buffer);
-    return exePath.parent_path();
+    return fs::path(Platform::getExeDirectory());
 }
 
 // Static method: Load all screens from files
-std::vector<Screen> Screen::loadScreensFromFiles() {
+std::vector<Screen> Screen::loadScreensFromFiles(const std::string& levelDir) {
     std::vector<std::string> mapFiles;
     fs::path baseDir = getExeDir();
     // Also consider parent of exe dir and current path
     std::vector<fs::path> dirs{ baseDir, baseDir.parent_path(), fs::current_path() };
+    if (!levelDir.empty()) {
+        dirs = { fs::path(levelDir) };  // A level pack is used on its own
+    }
     try {
         for (const auto& dir : dirs) {
             for (const auto& entry : fs::directory_iterator(dir)) {
@@ -393,6 +468,7 @@ std::vector<Screen> Screen::loadScreensFromFiles() {
     mapFiles.erase(std::unique(mapFiles.begin(), mapFiles.end()), mapFiles.end());
     
     std::vector<Screen> screens;
+    screens.reserve(mapFiles.size());  // One allocation holds every room's grid
     for (auto& fullPath : mapFiles) {
         LoadedScreen loaded = loadScreenFile(fullPath);
         if (!loaded.screenLines.empty()) {
@@ -401,6 +477,7 @@ std::vector<Screen> Screen::loadScreensFromFiles() {
             screens.back().metadata_ = loaded.metadata;
             // Copy dark zones to data_ for runtime access
             screens.back().data_.getDarkZonesMutable() = loaded.metadata.getDarkZones();
+            screens.back().rebuildDarkMask();
         } else {
             FileParser::reportError("Failed to load screen file: " + fullPath);
         }
@@ -418,6 +495,7 @@ void Screen::scanScreenData(int roomIdx) {
     data_.springs.clear();
     data_.switches.clear();
     data_.pressureButtons.clear();
+    data_.pressureTargets.clear();
     
     // Scan springs
     std::set<std::pair<int,int>> visited;
@@ -466,22 +544,64 @@ void Screen::scanScreenData(int roomIdx) {
         }
     }
 
+    reindexEntities();
+
     // Attach metadata targets to pressure buttons
     for (const auto& meta : metadata_.getPressureButtons()) {
         PressureButton* pb = PressureButton::findAt(*this, meta.getPosition());
         if (!pb) {
             data_.pressureButtons.emplace_back(roomIdx, meta.getPosition());
+            entityIndex_.add(EntityIndex::PressureButton, meta.getPosition(), (int)data_.pressureButtons.size() - 1);
             pb = &data_.pressureButtons.back();
         }
         pb->setTargets(meta.getClearTargets(), *this);
     }
+
+    // One reference-counted cell per target; the first button listing it gives its original glyph
+    std::map<std::pair<int, int>, int> targetCellAt;
+    for (auto& pb : data_.pressureButtons) {
+        for (const auto& tgt : pb.getTargets()) {
+            auto key = std::make_pair(tgt.getPos().getX(), tgt.getPos().getY());
+            auto it = targetCellAt.find(key);
+            if (it == targetCellAt.end()) {
+                it = targetCellAt.emplace(key, (int)data_.pressureTargets.size()).first;
+                data_.pressureTargets.emplace_back(tgt.getPos(), tgt.getOriginalChar());
+            }
+            pb.addTargetCell(it->second);
+        }
+    }
+}
+
+void Screen::reindexEntities() {
+    entityIndex_.clear(EntityIndex::Spring);
+    for (int i = 0; i < (int)data_.springs.size(); ++i) {
+        for (const Point& cell : data_.springs[i].getCells()) {
+            entityIndex_.add(EntityIndex::Spring, cell, i);
+        }
+    }
+
+    entityIndex_.clear(EntityIndex::Switch);
+    for (int i = 0; i < (int)data_.switches.size(); ++i) {
+        entityIndex_.add(EntityIndex::Switch, data_.switches[i].getPos(), i);
+    }
+
+    entityIndex_.clear(EntityIndex::PressureButton);
+    for (int i = 0; i < (int)data_.pressureButtons.size(); ++i) {
+        entityIndex_.add(EntityIndex::PressureButton, data_.pressureButtons[i].getPos(), i);
+    }
+
+    entityIndex_.clear(EntityIndex::SpecialDoor);
+    for (int i = 0; i < (int)data_.doors.size(); ++i) {
+        entityIndex_.add(EntityIndex::SpecialDoor, data_.doors[i].getPosition(), i);
+    }
 }
 
 // Static method: Scan ALL data for all screens
 void Screen::scanAllScreens(std::vector<Screen>& world, 
                              const RoomConnections& roomConnections,
                              std::map<RiddleKey, Riddle*>& riddlesByPosition,
-                             Legend& legend) {
+                             Legend& legend,
+                             ObstacleRegistry& obstacles) {
     
     // 1. Scan springs and switches in each screen
     for (size_t room = 0; room < world.size(); ++room) {
@@ -490,9 +610,13 @@ void Screen::scanAllScreens(std::vector<Screen>& world,
     
     // 2. Scan special doors (global configuration)
     SpecialDoor::scanAndPopulate(world);
+    for (auto& screen : world) {
+        screen.reindexEntities();
+    }
+    SpecialDoor::linkSwitches(world);
     
     // 3. Scan obstacles (BFS across rooms)
-    Obstacle::scanAllObstacles(world, roomConnections);
+    Obstacle::scanAllObstacles(world, roomConnections, obstacles);
     
     // 4. Scan riddles (global configuration)
     Riddle::scanAllRiddles(riddlesByPosition);
@@ -520,6 +644,15 @@ void Screen::lightDarkZone(const Point& p) {
     }
 }
 
+bool Screen::isInMessageBox(const Point& p) const {
+    const MessageBoxMetadata& msg = metadata_.getMessageBox();
+    if (!msg.getHasMessage() || msg.getBoxWidth() <= 0) return false;
+    
+    Point anchor = msg.getAnchorPos();
+    return p.getX() >= anchor.getX() && p.getX() < anchor.getX() + msg.getBoxWidth() &&
+           p.getY() >= anchor.getY() && p.getY() < anchor.getY() + 3;
+}
+
 // Render the message box content from metadata
 void Screen::renderMessageBox(const std::string& line1, const std::string& line2, const std::string& line3) {
     const MessageBoxMetadata& msg = metadata_.getMessageBox();
@@ -540,9 +673,7 @@ void Screen::renderMessageBox(const std::string& line1, const std::string& line2
         if (text.empty()) return;
         
         // Convert to wide string
-        int wlen = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), nullptr, 0);
-        std::wstring wtext(wlen, 0);
-        MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), &wtext[0], wlen);
+        std::wstring wtext = Platform::utf8ToWide(text);
         
         // Truncate if too long
         if ((int)wtext.size() > boxWidth) {
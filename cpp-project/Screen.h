@@ -1,9 +1,14 @@
 ﻿#pragma once
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
-#include <windows.h>
+#include <utility>
 #include "Point.h"
+#include "Glyph.h"
+#include "CellMask.h"
+#include "Lightmap.h"
+#include "EntityIndex.h"
 #include "Spring.h"
 #include "Switch.h"
 #include "PressureSwitch.h"
@@ -16,16 +21,46 @@ class Legend;
 class RoomConnections;
 class Riddle;
 class RiddleKey;
+class ScreenBuffer;
+class Board;
 
 class Screen {
 public:
     enum { MAX_X = 80, MAX_Y = 25 };
 private:
-    struct SpecialChar { wchar_t ch; }; 
-    std::vector<std::vector<SpecialChar>> m_grid;
-    std::vector<std::vector<SpecialChar>> m_originalGrid;  // Original state for tracking modifications
+    // Row-major cells stored inside the Screen itself, so a room's grid is one contiguous block
+    // and the world (a std::vector<Screen>) keeps every room's grid in a single allocation
+    using Grid = std::array<wchar_t, MAX_X * MAX_Y>;
+    Grid m_grid{};
+
+    // Modification journal: the original glyph of every cell changed since captureOriginalState,
+    // stored when the cell is first changed (a save or keyframe costs O(changed cells))
+    std::vector<std::pair<int, wchar_t>> m_journal;  // (cellIndex, original glyph)
+    CellMask m_journaled;           // Cells that have an entry in m_journal
+    bool m_hasOriginal = false;     // Set by captureOriginalState (journaling starts there)
+    Board* m_board = nullptr;  // Render target of refreshCell (owned by the Game)
+    unsigned long long m_changeCount = 0;  // Number of cells changed by setCharAt
+    unsigned long long m_stateHash = 0;    // XOR of StateHash::cell over the grid, outside the message box
+
+    // Cell masks kept in step with the grid by setCharAt
+    CellMask m_blockingMask;   // Glyph::Tile::Blocking (walls and doors)
+    CellMask m_obstacleMask;   // Pushable obstacle cells
+    CellMask m_bombableMask;   // Weak walls a bomb destroys
+    CellMask m_occupiedMask;   // Every cell that is not Glyph::Empty
+    CellMask m_torchMask;      // Torches lying on the screen
+    std::vector<Point> m_torches;  // The same torches as a list (in no particular order)
+    CellMask m_darkMask;       // Cells inside a dark zone (fixed once the screen is loaded)
+    mutable Lightmap m_lightmap;  // Cache behind syncLightmap
+    CellMask m_playerMask;     // Cells players stand on (see Game::syncPlayerOccupancy)
+
+    void writeCell(int x, int y, wchar_t newChar);  // Change a cell, keeping the hash and masks in step
+    void recomputeStateHash();
+    void rebuildCellMasks();
+    void updateCellMasks(int x, int y, wchar_t ch);
+    void rebuildDarkMask();
 
     void initFromWideLines(const std::vector<std::wstring>& lines);
+    static constexpr int cellIndex(int x, int y) { return y * MAX_X + x; }
 
 public:
     // Per-screen scanned data holder
@@ -36,8 +71,8 @@ public:
         std::vector<SpringData> springs;
         std::vector<SwitchData> switches;
         std::vector<PressureButton> pressureButtons;
+        std::vector<PressureTargetCell> pressureTargets;  // Every cell the buttons clear, once
         std::vector<SpecialDoor> doors;
-        std::vector<Obstacle> obstacles;
         
         // Dark zone accessors
         const std::vector<DarkZone>& getDarkZones() const { return darkZones_; }
@@ -48,29 +83,66 @@ public:
     Screen(const std::vector<std::wstring>& mapData) { initFromWideLines(mapData); }
     Screen(const std::vector<std::string>& mapData);
 
-    void draw() const;
-    wchar_t getCharAt(const Point& p) const;
+    void draw(ScreenBuffer& buffer) const;
+    wchar_t getCharAt(const Point& p) const {
+        if (p.getX() < 0 || p.getX() >= MAX_X || p.getY() < 0 || p.getY() >= MAX_Y) return Glyph::Empty;
+        return m_grid[cellIndex(p.getX(), p.getY())];
+    }
     void setCharAt(const Point& p, wchar_t newChar);
     void erase(const Point& p);
     void refreshCell(const Point& p) const;
     void refreshCells(const std::vector<Point>& pts) const;
+
+    // Grows every time setCharAt actually changes a cell
+    unsigned long long getChangeCount() const { return m_changeCount; }
+
+    // Hash of the grid, kept up to date by setCharAt (message box cells are display-only and left out)
+    unsigned long long getStateHash() const { return m_stateHash; }
+
+    // Cell masks: collision, blast and darkness queries as bit tests and word-wide operations
+    const CellMask& getBlockingMask() const { return m_blockingMask; }
+    const CellMask& getObstacleMask() const { return m_obstacleMask; }
+    const CellMask& getBombableMask() const { return m_bombableMask; }
+    const CellMask& getOccupiedMask() const { return m_occupiedMask; }
+    const CellMask& getTorchMask() const { return m_torchMask; }
+    const std::vector<Point>& getTorches() const { return m_torches; }
+
+    // Darkness levels of the dark zones for the given players' torches (updated on demand)
+    const Lightmap& syncLightmap(const std::vector<class Player>& players, int roomIdx) const {
+        m_lightmap.sync(*this, players, roomIdx);
+        return m_lightmap;
+    }
+    const CellMask& getDarkMask() const { return m_darkMask; }
+    const CellMask& getPlayerMask() const { return m_playerMask; }
+    void setPlayerAt(const Point& p, bool occupied) { m_playerMask.set(p, occupied); }
+
+    // Board that refreshCell draws through; nullptr disables cell refreshes
+    void setBoard(Board* board) { m_board = board; }
     
     // Track modifications from original state
     void captureOriginalState();  // Call after loading to save original
+    void restoreOriginalState();  // Undo all modifications (before applying a keyframe)
     std::vector<std::tuple<int, int, wchar_t>> getModifications() const;  // Get all changes from original
 
     // Access per-screen data
     const Data& getData() const { return data_; }
     Data& getDataMutable() { return data_; }
 
+    // Which entry of the data lists covers each cell (what findAt looks up).
+    // Rebuild with reindexEntities after changing the lists.
+    const EntityIndex& getEntityIndex() const { return entityIndex_; }
+    void reindexEntities();
+
     // Static methods for loading and scanning screens
-    static std::vector<Screen> loadScreensFromFiles();
+    // Empty levelDir = next to the executable, its parent and the working directory
+    static std::vector<Screen> loadScreensFromFiles(const std::string& levelDir = "");
     
     // Scan ALL data for all screens: springs, switches, doors, obstacles, riddles, legends
     static void scanAllScreens(std::vector<Screen>& world, 
                                 const RoomConnections& roomConnections,
                                 std::map<RiddleKey, Riddle*>& riddlesByPosition,
-                                Legend& legend);
+                                Legend& legend,
+                                ObstacleRegistry& obstacles);
     
     // Scan this screen's data (springs, switches)
     void scanScreenData(int roomIdx);
@@ -88,6 +160,9 @@ public:
     // Render the message box content from metadata (called once when entering room)
     void renderMessageBox(const std::string& line1, const std::string& line2, const std::string& line3);
     
+    // True for cells written by renderMessageBox (display-only content, not game state)
+    bool isInMessageBox(const Point& p) const;
+    
     // Structure to hold loaded screen with metadata
     struct LoadedScreen {
         std::vector<std::wstring> screenLines;  // The visual screen content (first 25 lines)
@@ -102,5 +177,6 @@ public:
 
 private:
     Data data_;
+    EntityIndex entityIndex_;
     ScreenMetadata metadata_;
 };
\ No newline at end of file
@@ -1,79 +1,216 @@
 #include "ScreenBuffer.h"
+#include "Platform.h"
+#include <algorithm>
+#include <chrono>
+#include <ostream>
 
-ScreenBuffer& ScreenBuffer::getInstance() {
-    static ScreenBuffer instance;
-    return instance;
+const ScreenBuffer* ScreenBuffer::onConsole_ = nullptr;
+
+ScreenBuffer::ScreenBuffer()
+    : buffer_(WIDTH * HEIGHT, L' '),
+      previousBuffer_(WIDTH * HEIGHT, L'\0') { // Different from buffer to force first flush
+    damagedRows_.reserve(HEIGHT);
+    damageAll();
+    for (Frame& frame : frames_) {
+        frame.cells.assign(WIDTH * HEIGHT, L' ');  // Sized once, so publishing a frame never allocates
+    }
 }
 
-ScreenBuffer::ScreenBuffer() {
-    buffer_.resize(HEIGHT, std::vector<wchar_t>(WIDTH, L' '));
-    previousBuffer_.resize(HEIGHT, std::vector<wchar_t>(WIDTH, L'\0')); // Different from buffer to force first flush
-    hConsole_ = GetStdHandle(STD_OUTPUT_HANDLE);
+ScreenBuffer::~ScreenBuffer() {
+    stopRenderThread();
+}
+
+void ScreenBuffer::damageAll() {
+    for (int y = 0; y < HEIGHT; ++y) {
+        damage(0, y);
+        damage(WIDTH - 1, y);
+    }
 }
 
 void ScreenBuffer::clear() {
     for (int y = 0; y < HEIGHT; ++y) {
         for (int x = 0; x < WIDTH; ++x) {
-            buffer_[y][x] = L' ';
+            setChar(x, y, L' ');
         }
     }
-    dirty_ = true;
 }
 
 void ScreenBuffer::setChar(int x, int y, wchar_t ch) {
     if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
-    if (buffer_[y][x] != ch) {
-        buffer_[y][x] = ch;
-        dirty_ = true;
+    wchar_t& cell = buffer_[y * WIDTH + x];
+    if (cell != ch) {
+        cell = ch;
+        damage(x, y);
     }
 }
 
 wchar_t ScreenBuffer::getChar(int x, int y) const {
     if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return L' ';
-    return buffer_[y][x];
+    return buffer_[y * WIDTH + x];
+}
+
+void ScreenBuffer::writeText(int x, int y, const std::wstring& text) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        setChar(x + (int)i, y, text[i]);
+    }
 }
 
 void ScreenBuffer::flush() {
-    if (!dirty_) return;
+    // Another buffer drew on the console since our last frame
+    if (onConsole_ != this) {
+        invalidate();
+        onConsole_ = this;
+    }
+    if (damagedRows_.empty()) return;
 
-    // Write entire buffer to console, line by line
-    // This is more efficient than character-by-character and eliminates flicker
-    for (int y = 0; y < HEIGHT; ++y) {
-        // Check if this line changed
-        bool lineChanged = false;
-        for (int x = 0; x < WIDTH; ++x) {
-            if (buffer_[y][x] != previousBuffer_[y][x]) {
-                lineChanged = true;
-                break;
+    if (renderThread_.joinable()) {
+        // Publish: copy the frame into the back slot and swap it with the ready one
+        Frame& frame = frames_[back_];
+        frame.cells = buffer_;
+        frame.damage = damage_;
+        frame.repaint = repaint_;
+        frame.key = frameKey_;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (hasReady_) {
+                // The render thread did not take the previous frame: this one replaces it,
+                // so it must also carry what changed in it
+                frame.damage.merge(frames_[ready_].damage);
+                frame.repaint = frame.repaint || frames_[ready_].repaint;
             }
+            std::swap(back_, ready_);
+            hasReady_ = true;
         }
-        
-        if (lineChanged) {
-            // Build the line string
-            std::wstring line;
-            line.reserve(WIDTH);
-            for (int x = 0; x < WIDTH; ++x) {
-                line.push_back(buffer_[y][x]);
-                previousBuffer_[y][x] = buffer_[y][x];
-            }
-            
-            // Write the entire line at once
-            COORD pos{0, (SHORT)y};
-            SetConsoleCursorPosition(hConsole_, pos);
-            DWORD written;
-            WriteConsoleW(hConsole_, line.c_str(), (DWORD)line.size(), &written, nullptr);
-        }
+        frameReady_.notify_one();
+    } else {
+        present(buffer_.data(), damage_, repaint_, frameKey_);
+    }
+
+    for (int y : damagedRows_) {
+        damage_.from[y] = damage_.to[y] = 0;
     }
-    
-    dirty_ = false;
+    damagedRows_.clear();
+    repaint_ = false;
 }
 
-void ScreenBuffer::invalidate() {
-    // Reset previousBuffer to force full redraw on next flush
+void ScreenBuffer::present(const wchar_t* cells, const Damage& damage, bool repaint, int key) {
+    auto start = std::chrono::steady_clock::now();
+    if (repaint) {
+        std::fill(previousBuffer_.begin(), previousBuffer_.end(), L'\0');
+    }
+
+    // The damaged spans, top to bottom
+    std::array<Platform::RowSpan, HEIGHT> spans;
+    int spanCount = 0;
     for (int y = 0; y < HEIGHT; ++y) {
-        for (int x = 0; x < WIDTH; ++x) {
-            previousBuffer_[y][x] = L'\0';
+        if (damage.from[y] < damage.to[y]) {
+            spans[spanCount++] = { y, damage.from[y], damage.to[y] };
         }
     }
-    dirty_ = true;
+
+    // The platform writes only what differs from the previous frame, in one go
+    // (this eliminates flicker)
+    Platform::FrameOutput output = Platform::writeFrame(cells, previousBuffer_.data(), WIDTH,
+                                                        spans.data(), spanCount);
+    for (int i = 0; i < spanCount; ++i) {
+        const Platform::RowSpan& span = spans[i];
+        std::copy(cells + span.y * WIDTH + span.from, cells + span.y * WIDTH + span.to,
+                  previousBuffer_.begin() + span.y * WIDTH + span.from);
+    }
+
+    FlushStats stats;
+    stats.rowsScanned = output.rowsScanned;
+    stats.rowsWritten = output.rowsWritten;
+    stats.cellsChanged = output.cellsChanged;
+    stats.bytes = output.bytes;
+    stats.writeCalls = output.writeCalls;
+    stats.microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostream* log;
+    int game;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastFlush_ = stats;
+        totalFlush_.rowsScanned += stats.rowsScanned;
+        totalFlush_.rowsWritten += stats.rowsWritten;
+        totalFlush_.cellsChanged += stats.cellsChanged;
+        totalFlush_.bytes += stats.bytes;
+        totalFlush_.writeCalls += stats.writeCalls;
+        totalFlush_.microseconds += stats.microseconds;
+        flushCount_++;
+        log = statsLog_;
+        game = statsGame_;
+    }
+
+    if (log) {
+        *log << game << ',' << key << ',' << stats.rowsScanned << ',' << stats.rowsWritten << ','
+             << stats.cellsChanged << ',' << stats.bytes << ',' << stats.writeCalls << ','
+             << stats.microseconds << '\n';
+    }
+}
+
+void ScreenBuffer::invalidate() {
+    // Forget what is on the console: the next frame repaints every cell
+    repaint_ = true;
+    damageAll();
+}
+
+void ScreenBuffer::startRenderThread() {
+    if (renderThread_.joinable()) return;
+    stopping_ = false;
+    renderThread_ = std::thread(&ScreenBuffer::renderLoop, this);
+}
+
+void ScreenBuffer::stopRenderThread() {
+    if (!renderThread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    frameReady_.notify_one();
+    renderThread_.join();
+}
+
+void ScreenBuffer::renderLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        frameReady_.wait(lock, [this] { return hasReady_ || stopping_; });
+        if (!hasReady_) break;  // Stopping, and the last frame is already on the console
+
+        // Take the latest frame; the console write happens outside the lock
+        std::swap(front_, ready_);
+        hasReady_ = false;
+        lock.unlock();
+        const Frame& frame = frames_[front_];
+        present(frame.cells.data(), frame.damage, frame.repaint, frame.key);
+        lock.lock();
+    }
+}
+
+ScreenBuffer::FlushStats ScreenBuffer::getLastFlushStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastFlush_;
+}
+
+ScreenBuffer::FlushStats ScreenBuffer::getTotalFlushStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totalFlush_;
+}
+
+int ScreenBuffer::getFlushCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flushCount_;
+}
+
+void ScreenBuffer::resetFlushStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastFlush_ = FlushStats();
+    totalFlush_ = FlushStats();
+    flushCount_ = 0;
+}
+
+void ScreenBuffer::setStatsLog(std::ostream* csv, int game) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statsLog_ = csv;
+    statsGame_ = game;
 }
@@ -1,17 +1,29 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <string>
-#include <windows.h>
+#include <iosfwd>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 // Double buffering for flicker-free console rendering.
 // All draw operations write to this buffer, then flush() writes everything at once.
+// setChar records the damaged span of each row, so a flush costs what changed, not the whole screen.
+// With a render thread running, flush() only publishes the frame into a triple buffer and the
+// thread writes the latest one to the console (frames it had no time for are merged, not queued).
+// Each Game owns its own buffer, so several games can live in one process.
 class ScreenBuffer {
 public:
     static constexpr int WIDTH = 80;
     static constexpr int HEIGHT = 25;
 
-    // Get the singleton instance
-    static ScreenBuffer& getInstance();
+    ScreenBuffer();
+    ~ScreenBuffer();
+
+    // Disable copying
+    ScreenBuffer(const ScreenBuffer&) = delete;
+    ScreenBuffer& operator=(const ScreenBuffer&) = delete;
 
     // Clear the buffer (fill with spaces)
     void clear();
@@ -22,29 +34,116 @@ public:
     // Get a character at a position
     wchar_t getChar(int x, int y) const;
 
-    // Write entire buffer to console (call once per frame)
+    // Write a run of characters starting at (x, y), clipped to the buffer
+    void writeText(int x, int y, const std::wstring& text);
+
+    // Write the changes since the last flush to the console (call once per frame).
+    // The first flush of a buffer, or after another buffer was flushed, repaints every cell.
+    // With the render thread running this never waits for the console.
     void flush();
 
-    // Mark that buffer content has changed and needs flushing
-    void markDirty() { dirty_ = true; }
-    
-    // Check if buffer is dirty
-    bool isDirty() const { return dirty_; }
-    
+    // Check if any cell changed since the last flush
+    bool isDirty() const { return !damagedRows_.empty(); }
+
     // Invalidate the previous buffer to force full redraw on next flush
-    // Call this after cls() to ensure screen is fully redrawn
+    // Call this after writing to the console without the buffer
     void invalidate();
 
+    // Console writes on a thread of their own (see DisplayBoard). Stopping writes the last
+    // published frame before returning; both are no-ops when already in that state.
+    void startRenderThread();
+    void stopRenderThread();
+
+    // What a flush cost
+    struct FlushStats {
+        int rowsScanned = 0;       // Rows compared with the previous frame
+        int rowsWritten = 0;       // Rows with at least one cell sent to the console
+        int cellsChanged = 0;      // Cells that differ from the previous frame
+        size_t bytes = 0;          // Bytes sent to the console
+        int writeCalls = 0;        // Output system calls
+        double microseconds = 0;   // Time spent in flush
+    };
+
+    // The last frame written to the console, and the sums over all of them since resetFlushStats
+    // (copies, as the render thread may be writing the next frame)
+    FlushStats getLastFlushStats() const;
+    FlushStats getTotalFlushStats() const;
+    int getFlushCount() const;
+    void resetFlushStats();
+
+    // Optional CSV log: a row per frame written, keyed by the game number and the frame key (the game
+    // sets it to its cycle). The caller writes the header (see Game::runApp); nullptr turns it off and
+    // the stream must outlive the logging.
+    void setStatsLog(std::ostream* csv, int game = 0);
+    void setFrameKey(int key) { frameKey_ = key; }
+
 private:
-    ScreenBuffer();
-    ~ScreenBuffer() = default;
-    
-    // Disable copying
-    ScreenBuffer(const ScreenBuffer&) = delete;
-    ScreenBuffer& operator=(const ScreenBuffer&) = delete;
+    // Damaged cells of a frame: [from[y], to[y]) of each row (empty when from >= to)
+    struct Damage {
+        std::array<int, HEIGHT> from{};
+        std::array<int, HEIGHT> to{};
+
+        void add(int y, int x0, int x1) {
+            if (from[y] >= to[y]) {
+                from[y] = x0;
+                to[y] = x1;
+            } else {
+                if (x0 < from[y]) from[y] = x0;
+                if (x1 > to[y]) to[y] = x1;
+            }
+        }
+        void merge(const Damage& other) {
+            for (int y = 0; y < HEIGHT; ++y) {
+                if (other.from[y] < other.to[y]) add(y, other.from[y], other.to[y]);
+            }
+        }
+    };
+
+    // A frame published by flush: the cells, what changed since the frame before it and
+    // whether the console must be repainted first
+    struct Frame {
+        std::vector<wchar_t> cells;
+        Damage damage;
+        bool repaint = false;
+        int key = 0;
+    };
+
+    // Simulation side: row-major WIDTH x HEIGHT cells and the damage since the last flush
+    std::vector<wchar_t> buffer_;
+    Damage damage_;
+    std::vector<int> damagedRows_;  // Rows with damage, each once
+    bool repaint_ = true;           // The console copy is unknown (first frame, invalidate)
+    int frameKey_ = 0;
+
+    void damage(int x, int y) {
+        if (damage_.from[y] >= damage_.to[y]) damagedRows_.push_back(y);
+        damage_.add(y, x, x + 1);
+    }
+    void damageAll();
+
+    // Console side: only the thread that writes to the console touches these
+    std::vector<wchar_t> previousBuffer_; // What the console shows (for dirty-region optimization)
+    void present(const wchar_t* cells, const Damage& damage, bool repaint, int key);
+
+    // Triple buffer: flush fills frames_[back_] and swaps it with ready_, the render thread
+    // swaps ready_ with front_ and writes that; the swaps are the only shared steps
+    std::array<Frame, 3> frames_;
+    int back_ = 0;
+    int ready_ = 1;
+    int front_ = 2;
+    bool hasReady_ = false;   // frames_[ready_] was published and not taken yet
+    bool stopping_ = false;
+    std::thread renderThread_;
+    mutable std::mutex mutex_;  // Guards the indices above, the flush statistics and statsLog_
+    std::condition_variable frameReady_;
+    void renderLoop();
+
+    // The buffer whose previous frame is on the console (there is only one console)
+    static const ScreenBuffer* onConsole_;
 
-    std::vector<std::vector<wchar_t>> buffer_;
-    std::vector<std::vector<wchar_t>> previousBuffer_; // For dirty-region optimization
-    bool dirty_ = true;
-    HANDLE hConsole_;
+    FlushStats lastFlush_;
+    FlushStats totalFlush_;
+    int flushCount_ = 0;
+    std::ostream* statsLog_ = nullptr;
+    int statsGame_ = 0;
 };
@@ -0,0 +1,100 @@
+#include "SegmentVerifier.h"
+#include "BatchVerifier.h"
+#include "Game.h"
+#include "FileParser.h"
+#include "GameRecorder.h"
+#include "Keyframe.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Replay one segment in its own Game, starting from `from` (nullptr = game start).
+// `expectedEnd` is the keyframe the next segment starts from (nullptr for the last segment).
+SegmentVerifier::SegmentResult verifySegment(const std::string& directory, const Keyframe* from, const Keyframe* expectedEnd) {
+    SegmentVerifier::SegmentResult result;
+    result.startCycle = from ? from->getCycle() : 0;
+    result.endCycle = expectedEnd ? expectedEnd->getCycle() : -1;
+
+    result.error = BatchVerifier::captureErrors([&]() {
+        Game game(GameMode::LoadSilent, directory);
+        Keyframe endState;
+        result.reachedEnd = game.runSegment(from, result.endCycle, endState, result.firstMismatchCycle);
+        if (expectedEnd) {
+            result.stateMatches = result.reachedEnd && endState.hash() == expectedEnd->hash();
+        }
+        result.passed = result.reachedEnd && result.stateMatches && result.firstMismatchCycle < 0;
+    });
+    return result;
+}
+
+} // namespace
+
+bool SegmentVerifier::run(const std::string& directory, int threadCount) {
+    GameRecorder recording;
+    if (!recording.initForLoad(directory)) {
+        FileParser::reportError("Failed to load game recording files");
+        std::cout << "\n*** TEST FAILED ***\n" << std::endl;
+        return false;
+    }
+
+    // The first segment starts from a fresh game, so a keyframe at cycle 0 adds nothing
+    std::vector<Keyframe> keyframes = recording.loadKeyframes();
+    keyframes.erase(std::remove_if(keyframes.begin(), keyframes.end(),
+                                   [](const Keyframe& k) { return k.getCycle() <= 0; }),
+                    keyframes.end());
+
+    // Segment i starts at keyframe i-1 (segment 0 at the game start) and ends at keyframe i
+    size_t segmentCount = keyframes.size() + 1;
+
+    std::vector<SegmentResult> results(segmentCount);
+
+    auto start = std::chrono::steady_clock::now();
+    threadCount = BatchVerifier::runParallel(segmentCount, threadCount, [&](size_t i) {
+        const Keyframe* from = (i == 0) ? nullptr : &keyframes[i - 1];
+        const Keyframe* expectedEnd = (i < keyframes.size()) ? &keyframes[i] : nullptr;
+        results[i] = verifySegment(directory, from, expectedEnd);
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t failed = 0;
+    for (const auto& r : results) {
+        if (!r.passed) ++failed;
+    }
+
+    std::ostringstream oss;
+    oss << "\n========== SEGMENT VERIFICATION ==========\n";
+    oss << "Segments: " << results.size() << "  Passed: " << (results.size() - failed)
+        << "  Failed: " << failed << "\n";
+    oss << "Threads:  " << threadCount << "  Time: " << std::fixed << std::setprecision(3) << seconds << " s\n";
+    oss << "--------------------------------------------\n";
+    for (const auto& r : results) {
+        oss << (r.passed ? "[OK]    " : "[FAIL]  ") << "cycles " << r.startCycle << " - ";
+        if (r.endCycle >= 0) {
+            oss << r.endCycle;
+        } else {
+            oss << "end";
+        }
+        if (!r.reachedEnd) {
+            oss << " - game ended before the segment end";
+        } else if (!r.stateMatches) {
+            oss << " - state differs from the keyframe at cycle " << r.endCycle;
+        }
+        if (r.firstMismatchCycle >= 0) {
+            oss << " - first mismatch at cycle " << r.firstMismatchCycle;
+        }
+        if (!r.error.empty()) {
+            oss << " - " << r.error;
+        }
+        oss << "\n";
+    }
+    oss << "============================================\n";
+    oss << (failed == 0 ? "\n*** TEST PASSED ***\n" : "\n*** TEST FAILED ***\n");
+    std::cout << oss.str() << std::endl;
+
+    return failed == 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Verifies a single long recording in parallel.
+// The keyframes written in Save mode split the recording into segments; each segment is
+// replayed silently by its own Game on a pool of worker threads, starting from its keyframe.
+// A segment passes when its results match the expected ones and the state it ends in hashes
+// the same as the keyframe the next segment starts from.
+class SegmentVerifier {
+public:
+    // Outcome of replaying a single segment
+    struct SegmentResult {
+        int startCycle = 0;
+        int endCycle = -1;            // -1 for the last segment (runs to the end of the recording)
+        bool passed = false;
+        bool reachedEnd = false;      // Simulation got to endCycle (the game did not end before)
+        bool stateMatches = true;     // End state hash equals the next keyframe's hash
+        int firstMismatchCycle = -1;  // First result in the segment that differs from the expected one
+        std::string error;            // First error reported while loading/replaying
+    };
+
+    // Verify the recording in directory ("" = current directory) using threadCount workers
+    // (0 = hardware concurrency). Returns true if every segment passed.
+    static bool run(const std::string& directory, int threadCount = 0);
+};
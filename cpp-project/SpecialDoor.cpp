@@ -111,25 +111,31 @@ void SpecialDoor::scanAndPopulate(std::vector<Screen>& world) {
     loadDoorsFromMetadata(world);
 }
 
+void SpecialDoor::linkSwitches(std::vector<Screen>& world) {
+    for (auto& screen : world) {
+        auto& doors = screen.getDataMutable().doors;
+        for (int i = 0; i < (int)doors.size(); ++i) {
+            for (const auto& req : doors[i].getRequiredSwitches()) {
+                SwitchData* sw = SwitchData::findAt(screen, req.getPos());
+                if (sw) sw->addWatchingDoor(i);
+            }
+        }
+    }
+}
+
 void SpecialDoor::updateAll(Game& game) {
     int visibleRoomIdx = game.getVisibleRoomIdx();
-    int worldSize = game.getWorldSize();
     
-    for (int room = 0; room < worldSize; ++room) {
-        Screen& s = game.getScreen(room);
-        auto& doors = s.getDataMutable().doors;
-        
-        for (auto& door : doors) {
-            if (!door.isOpen() && door.areConditionsMet(game)) {
-                // Only remove the door glyph if it's NOT a teleport door
-                // Teleport doors stay visible so players can use them multiple times
-                if (door.getTargetRoomIdx() < 0) {
-                    Screen& doorScreen = game.getScreen(door.getRoomIdx());
-                    if (doorScreen.getCharAt(door.getPosition()) == Glyph::SpecialDoor) {
-                        doorScreen.setCharAt(door.getPosition(), Glyph::Empty);
-                        if (door.getRoomIdx() == visibleRoomIdx) {
-                            doorScreen.refreshCell(door.getPosition());
-                        }
+    for (SpecialDoor* door : game.takeDoorsToCheck()) {
+        if (!door->isOpen() && door->areConditionsMet(game)) {
+            // Only remove the door glyph if it's NOT a teleport door
+            // Teleport doors stay visible so players can use them multiple times
+            if (door->getTargetRoomIdx() < 0) {
+                Screen& doorScreen = game.getScreen(door->getRoomIdx());
+                if (doorScreen.getCharAt(door->getPosition()) == Glyph::SpecialDoor) {
+                    doorScreen.setCharAt(door->getPosition(), Glyph::Empty);
+                    if (door->getRoomIdx() == visibleRoomIdx) {
+                        doorScreen.refreshCell(door->getPosition());
                     }
                 }
             }
@@ -139,12 +145,5 @@ void SpecialDoor::updateAll(Game& game) {
 
 // Static: Find special door at position
 SpecialDoor* SpecialDoor::findAt(Screen& screen, const Point& p) {
-    auto& dataDoors = screen.getDataMutable().doors;
-    for (auto& door : dataDoors) {
-        Point doorPos = door.getPosition();
-        if (doorPos.getX() == p.getX() && doorPos.getY() == p.getY()) {
-            return &door;
-        }
-    }
-    return nullptr;
+    return screen.getEntityIndex().find(EntityIndex::SpecialDoor, screen.getDataMutable().doors, p);
 }
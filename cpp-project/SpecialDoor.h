@@ -61,12 +61,16 @@ public:
     void addRequiredKey(const Key& key) { requiredKeys_.push_back(key); }
     void addRequiredSwitch(const SwitchRequirement& sw) { requiredSwitches_.push_back(sw); }
     void addInsertedKey(const Key& key) { keysInserted_.push_back(key); }
+    void setKeysInserted(const std::vector<Key>& keys) { keysInserted_ = keys; }
 
     bool areConditionsMet(Game& game); // check if all conditions satisfied
     bool useKey(const Key& key);                  // attempt to insert a key
     
     // Static methods for managing all special doors
     static void scanAndPopulate(std::vector<Screen>& world);
+    // Register every door with the switches it requires (after the switches and the entity index are scanned)
+    static void linkSwitches(std::vector<Screen>& world);
+    // Open the doors whose keys or switches changed since the last update (Game::doorInputChanged)
     static void updateAll(Game& game);
     
     // Static: Find special door at position in a screen
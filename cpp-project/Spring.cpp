@@ -7,13 +7,7 @@
 
 // Static: Find spring at position
 SpringData* SpringData::findAt(Screen& screen, const Point& p) {
-    auto& data = screen.getDataMutable();
-    for (auto& sp : data.springs) {
-        if (sp.findCellIndex(p) != -1) {
-            return &sp;
-        }
-    }
-    return nullptr;
+    return screen.getEntityIndex().find(EntityIndex::Spring, screen.getDataMutable().springs, p);
 }
 
 // SpringLogic class static method implementations
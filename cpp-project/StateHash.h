@@ -0,0 +1,25 @@
+#pragma once
+
+// Hash helpers for the per-cycle world-state hash written into recordings.
+// Screens keep the XOR of cell() over their cells up to date in setCharAt, so the
+// full world hash only combines a handful of values per cycle.
+class StateHash {
+public:
+    // splitmix64 finalizer: every input bit affects every output bit
+    static constexpr unsigned long long mix(unsigned long long v) {
+        v += 0x9E3779B97F4A7C15ULL;
+        v = (v ^ (v >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        v = (v ^ (v >> 27)) * 0x94D049BB133111EBULL;
+        return v ^ (v >> 31);
+    }
+
+    // Order-dependent running hash (one multiply per value, pass the result through mix() at the end)
+    static constexpr unsigned long long combine(unsigned long long seed, unsigned long long v) {
+        return (((seed << 5) | (seed >> 59)) ^ v) * 0x517CC1B727220A95ULL;
+    }
+
+    // Contribution of one screen cell (XORed out and in again when the cell changes)
+    static constexpr unsigned long long cell(int x, int y, wchar_t ch) {
+        return mix(((unsigned long long)(y * 80 + x) << 32) | (unsigned long long)(unsigned int)ch);
+    }
+};
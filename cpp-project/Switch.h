@@ -1,5 +1,6 @@
 #pragma once
 #include "Point.h"
+#include <vector>
 
 // Forward declaration
 class Screen;
@@ -11,6 +12,7 @@ private:
     int roomIdx_;
     Point pos_;
     bool isOn_; // true = '1', false = '0'
+    std::vector<int> watchingDoors_; // Special doors of this room (index in its door list) that require this switch
     
 public:
     SwitchData(int room, Point p, bool initialState = false)
@@ -25,6 +27,11 @@ public:
     void toggle() {
         isOn_ = !isOn_;
     }
+    void setOn(bool on) { isOn_ = on; }
+
+    // Doors re-checked when this switch toggles (see SpecialDoor::linkSwitches)
+    const std::vector<int>& getWatchingDoors() const { return watchingDoors_; }
+    void addWatchingDoor(int doorIdx) { watchingDoors_.push_back(doorIdx); }
     
     // Get current display character
     wchar_t getDisplayChar() const {
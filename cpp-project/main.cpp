@@ -2,7 +2,11 @@
 #include "FileParser.h"
 #include "GameRecorder.h"
 #include "utils.h"
+#include "BatchVerifier.h"
+#include "SegmentVerifier.h"
+#include "DivergenceBisector.h"
 #include <iostream>
+#include <algorithm>
 #include <exception>
 #include <string>
 #include <cstring>
@@ -21,11 +25,36 @@ int main(int argc, char* argv[]) {
         // Clear any previous error state
         FileParser::clearErrors();
         
+        // Batch verification of a whole directory of recordings
+        std::string batchDir;
+        int threadCount = 0;
+        if (parseBatchArgs(argc, argv, batchDir, threadCount)) {
+            return BatchVerifier::run(batchDir, threadCount) ? 0 : 1;
+        }
+
+        // Bisect the recording in the current directory between two level packs or two builds
+        DivergenceBisector::Side sideA, sideB;
+        if (parseBisectArgs(argc, argv, sideA.levelDir, sideB.levelDir, sideB.executable)) {
+            return DivergenceBisector::run("", sideA, sideB) ? 0 : 1;
+        }
+
         // Parse command line arguments
         GameMode mode = parseCommandLineArgs(argc, argv);
         
-        // Run the appropriate game mode
-        Game::runApp(mode);
+        // State of a silent replay at one cycle (what -bisect -build reads from the other build)
+        int dumpCycle = parseDumpStateArg(argc, argv);
+        if (mode == GameMode::LoadSilent && dumpCycle >= 0) {
+            return DivergenceBisector::dumpState(dumpCycle, std::cout) ? 0 : 1;
+        }
+        
+        // A single silent recording split into keyframe segments verified in parallel
+        int seekCycle = parseSeekArg(argc, argv);
+        if (mode == GameMode::LoadSilent && seekCycle < 0 && parseSegmentsArg(argc, argv)) {
+            return SegmentVerifier::run("", (std::max)(parseThreadsArg(argc, argv), 0)) ? 0 : 1;
+        }
+        
+        // Run the appropriate game mode (playback may start at a given cycle, flushes may be logged)
+        Game::runApp(mode, seekCycle, parseFlushStatsArg(argc, argv));
         
         // Check if any non-fatal errors occurred during execution
         if (FileParser::hasErrors()) {
@@ -1,69 +1,28 @@
 #include <iostream>
-#include <windows.h>
+#include <cstdlib>
+#include <algorithm>
 #include "utils.h"
+#include "Platform.h"
 #include "ScreenBuffer.h"
 
 // This file base on Amir's tirgol
 
 void gotoxy(int x, int y) {
-    std::cout.flush();
-    COORD coord;
-    coord.X = x;
-    coord.Y = y;
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+    Platform::setCursorPosition(x, y);
 }
 
 void hideCursor() {
-    HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    CONSOLE_CURSOR_INFO curInfo;
-    GetConsoleCursorInfo(hStdOut, &curInfo);
-    curInfo.bVisible = FALSE;
-    SetConsoleCursorInfo(hStdOut, &curInfo);
+    Platform::hideCursor();
 }
 
-void cls() {
-    system("cls");
-    // Invalidate the screen buffer so next flush redraws everything
-    ScreenBuffer::getInstance().invalidate();
+void cls(ScreenBuffer& buffer) {
+    // Only the back buffer is cleared: the next flush writes just the cells that differ
+    // from what is on the console, so a room switch costs one frame write
+    buffer.clear();
 }
 
 void setConsoleFont() {
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    
-    // On Windows Terminal the font is controlled by the host, skip font change
-    bool isWindowsTerminal = (GetEnvironmentVariableW(L"WT_SESSION", nullptr, 0) > 0);
-
-    if (!isWindowsTerminal) {
-        CONSOLE_FONT_INFOEX cfi{};
-        cfi.cbSize = sizeof(cfi);
-        cfi.nFont = 0;
-        cfi.dwFontSize.X = 0;   // Let the system pick width for the chosen height
-        cfi.dwFontSize.Y = 18;  // Reasonable height for readability
-        cfi.FontFamily = FF_DONTCARE;
-        cfi.FontWeight = FW_NORMAL;
-        
-        // Prefer a TrueType font that supports Unicode box drawing
-        wcscpy_s(cfi.FaceName, L"Consolas");
-        if (!SetCurrentConsoleFontEx(hConsole, FALSE, &cfi)) {
-            // Fallback
-            wcscpy_s(cfi.FaceName, L"Lucida Console");
-            SetCurrentConsoleFontEx(hConsole, FALSE, &cfi);
-        }
-    }
-    
-    // Set console screen buffer size to match 80x25
-    COORD bufferSize;
-    bufferSize.X = 80;
-    bufferSize.Y = 25;
-    SetConsoleScreenBufferSize(hConsole, bufferSize);
-    
-    // Set window size
-    SMALL_RECT windowSize;
-    windowSize.Left = 0;
-    windowSize.Top = 0;
-    windowSize.Right = 79;  // 80 columns (0-79)
-    windowSize.Bottom = 24; // 25 rows (0-24)
-    SetConsoleWindowInfo(hConsole, TRUE, &windowSize);
+    Platform::initConsole();
 }
 
 // Parse command line arguments and determine game mode
@@ -89,4 +48,110 @@ GameMode parseCommandLineArgs(int argc, char* argv[]) {
     }
     
     return mode;
-}
\ No newline at end of file
+}
+
+// Parse batch verification arguments: -batch <dir> [-threads N]
+bool parseBatchArgs(int argc, char* argv[], std::string& rootDir, int& threadCount) {
+    bool batch = false;
+    threadCount = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-batch" && i + 1 < argc) {
+            batch = true;
+            rootDir = argv[++i];
+        }
+    }
+
+    threadCount = (std::max)(parseThreadsArg(argc, argv), 0);
+    return batch;
+}
+
+// Parse playback seek argument: -seek <cycle>
+int parseSeekArg(int argc, char* argv[]) {
+    int seekCycle = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-seek" && i + 1 < argc) {
+            seekCycle = std::atoi(argv[++i]);
+            if (seekCycle < 0) seekCycle = -1;
+        }
+    }
+
+    return seekCycle;
+}
+
+// Parse worker thread count: -threads <N>
+int parseThreadsArg(int argc, char* argv[]) {
+    int threadCount = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-threads" && i + 1 < argc) {
+            threadCount = (std::max)(std::atoi(argv[++i]), 0);
+        }
+    }
+
+    return threadCount;
+}
+
+// Parse segment verification argument: -segments
+bool parseSegmentsArg(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "-segments") {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parse divergence bisection arguments: -bisect [-levels <dirA> <dirB>] [-build <otherExe>]
+bool parseBisectArgs(int argc, char* argv[], std::string& levelDirA, std::string& levelDirB, std::string& otherBuild) {
+    bool bisect = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-bisect") {
+            bisect = true;
+        }
+        else if (arg == "-levels" && i + 2 < argc) {
+            levelDirA = argv[++i];
+            levelDirB = argv[++i];
+        }
+        else if (arg == "-build" && i + 1 < argc) {
+            otherBuild = argv[++i];
+        }
+    }
+
+    return bisect;
+}
+
+// Parse state dump argument: -dumpstate <cycle>
+int parseDumpStateArg(int argc, char* argv[]) {
+    int cycle = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-dumpstate" && i + 1 < argc) {
+            cycle = (std::max)(std::atoi(argv[++i]), 0);
+        }
+    }
+
+    return cycle;
+}
+
+// Parse flush statistics argument: -flushstats <file.csv>
+std::string parseFlushStatsArg(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "-flushstats") {
+            return argv[i + 1];
+        }
+    }
+    return "";
+}
@@ -1,18 +1,42 @@
 #pragma once
 
+#include <string>
 #include "GameRecorder.h"
 
+class ScreenBuffer;
+
 // Parse command line arguments and determine game mode
 GameMode parseCommandLineArgs(int argc, char* argv[]);
 
+// Parse "-batch <dir> [-threads N]"; returns false when batch mode was not requested
+bool parseBatchArgs(int argc, char* argv[], std::string& rootDir, int& threadCount);
+
+// Parse "-seek <cycle>" (playback start cycle); returns -1 when absent
+int parseSeekArg(int argc, char* argv[]);
+
+// Parse "-threads N" (0 = hardware concurrency); returns -1 when absent
+int parseThreadsArg(int argc, char* argv[]);
+
+// Parse "-segments" (verify a silent replay in keyframe segments, in parallel)
+bool parseSegmentsArg(int argc, char* argv[]);
+
+// Parse "-bisect [-levels <dirA> <dirB>] [-build <otherExe>]"; returns false when bisection was not requested
+bool parseBisectArgs(int argc, char* argv[], std::string& levelDirA, std::string& levelDirB, std::string& otherBuild);
+
+// Parse "-dumpstate <cycle>" (print the replay state at that cycle); returns -1 when absent
+int parseDumpStateArg(int argc, char* argv[]);
+
+// Parse "-flushstats <file.csv>" (log the cost of every console flush); returns an empty string when absent
+std::string parseFlushStatsArg(int argc, char* argv[]);
+
 // Moves the console cursor to specific (x, y) coordinates
 void gotoxy(int x, int y);
 
 // Hides the blinking cursor for a better game look
 void hideCursor();
 
-// Clears the screen (system cls)
-void cls();
+// Clears the given back buffer (the console follows on its next flush)
+void cls(ScreenBuffer& buffer);
 
 // Sets console font to Raster for proper UTF-8 box-drawing display
 void setConsoleFont();
\ No newline at end of file